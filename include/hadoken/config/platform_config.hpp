@@ -48,6 +48,45 @@
 #endif // HADOKEN_DECORATE_HOST_DEVICE
 
 
+// cache line size used for padding of concurrently accessed data
+#ifndef HADOKEN_CACHE_LINE_SIZE
+#   define HADOKEN_CACHE_LINE_SIZE 64
+#endif
+
+
+// restrict qualifier, no aliasing between pointers
+#ifndef HADOKEN_RESTRICT
+#   if (defined __GNUC__) || (defined __clang__)
+#       define HADOKEN_RESTRICT __restrict__
+#   elif (defined _MSC_VER)
+#       define HADOKEN_RESTRICT __restrict
+#   else
+#       define HADOKEN_RESTRICT
+#   endif
+#endif
+
+
+// vectorization hint for the loop that follows,
+// iterations are declared independent
+#ifndef HADOKEN_PRAGMA_SIMD
+#   if (defined _OPENMP) && (_OPENMP >= 201307)
+#       define HADOKEN_PRAGMA_SIMD _Pragma("omp simd")
+#   elif (defined __clang__)
+#       define HADOKEN_PRAGMA_SIMD _Pragma("clang loop vectorize(enable) interleave(enable)")
+#   elif (defined __GNUC__) && !(defined HADOKEN_COMPILER_IS_NVCC)
+#       define HADOKEN_PRAGMA_SIMD _Pragma("GCC ivdep")
+#   else
+#       define HADOKEN_PRAGMA_SIMD
+#   endif
+#endif
+
+
+// alignment in bytes of the vectorized loops main body
+#ifndef HADOKEN_SIMD_ALIGNMENT
+#   define HADOKEN_SIMD_ALIGNMENT 64
+#endif
+
+
 // compiler detector
 
 
@@ -29,6 +29,10 @@
 #ifndef CONCURRENT_QUEUE_BITS_HPP
 #define CONCURRENT_QUEUE_BITS_HPP
 
+#include <algorithm>
+#include <thread>
+#include <utility>
+
 #include "../concurrent_queue.hpp"
 
 namespace hadoken {
@@ -100,6 +104,567 @@ std::size_t concurrent_queue_stl_mut<T, ThreadModel, Allocator>::size() const{
 }
 
 
+namespace impl{
+
+// wait strategy of the lock-free queues: spin, then yield, then sleep
+inline void concurrent_queue_backoff(std::size_t & iteration){
+    if(iteration >= 128){
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }else if(iteration >= 64){
+#ifndef HADOKEN_SPIN_NO_YIELD
+        std::this_thread::yield();
+#endif
+    }
+    iteration++;
+}
+
+inline std::size_t concurrent_queue_round_capacity(std::size_t capacity){
+    std::size_t res = 2;
+    while(res < capacity){
+        res <<= 1;
+    }
+    return res;
+}
+
+} // impl
+
+
+template<typename T, typename ThreadModel>
+inline concurrent_queue_ring_mpmc<T, ThreadModel>::concurrent_queue_ring_mpmc(std::size_t capacity) :
+    _mask(impl::concurrent_queue_round_capacity(capacity) - 1),
+    _cells(new cell[_mask + 1]),
+    _enqueue_pos(0),
+    _dequeue_pos(0)
+{
+    for(std::size_t i = 0; i <= _mask; ++i){
+        _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template<typename T, typename ThreadModel>
+inline concurrent_queue_ring_mpmc<T, ThreadModel>::~concurrent_queue_ring_mpmc(){
+    // destroy the remaining elements
+    optional<T> res;
+    while(_try_pop(res)){}
+}
+
+
+template<typename T, typename ThreadModel>
+template<typename U>
+inline bool concurrent_queue_ring_mpmc<T, ThreadModel>::_try_emplace(U && element){
+    std::size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+
+    while(1){
+        cell & c = _cells[pos & _mask];
+        const std::size_t seq = c.sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos);
+
+        if(diff == 0){
+            if(_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                new (&c.storage) T(std::forward<U>(element));
+                c.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }else if(diff < 0){
+            // full
+            return false;
+        }else{
+            pos = _enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+
+template<typename T, typename ThreadModel>
+inline bool concurrent_queue_ring_mpmc<T, ThreadModel>::_try_pop(optional<T> & res){
+    std::size_t pos = _dequeue_pos.load(std::memory_order_relaxed);
+
+    while(1){
+        cell & c = _cells[pos & _mask];
+        const std::size_t seq = c.sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos + 1);
+
+        if(diff == 0){
+            if(_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                T* elem = reinterpret_cast<T*>(&c.storage);
+                res = std::move(*elem);
+                elem->~T();
+                c.sequence.store(pos + _mask + 1, std::memory_order_release);
+                return true;
+            }
+        }else if(diff < 0){
+            // empty
+            return false;
+        }else{
+            pos = _dequeue_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+
+template<typename T, typename ThreadModel>
+inline void concurrent_queue_ring_mpmc<T, ThreadModel>::push(T element){
+    std::size_t iteration = 0;
+    while(_try_emplace(std::move(element)) == false){
+        impl::concurrent_queue_backoff(iteration);
+    }
+}
+
+template<typename T, typename ThreadModel>
+inline bool concurrent_queue_ring_mpmc<T, ThreadModel>::try_push(T && element){
+    return _try_emplace(std::move(element));
+}
+
+template<typename T, typename ThreadModel>
+inline bool concurrent_queue_ring_mpmc<T, ThreadModel>::try_push(const T & element){
+    return _try_emplace(element);
+}
+
+
+template<typename T, typename ThreadModel>
+template<typename Duration>
+inline optional<T> concurrent_queue_ring_mpmc<T, ThreadModel>::try_pop(const Duration & d){
+    optional<T> res;
+
+    if(_try_pop(res)){
+        return res;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + d;
+    std::size_t iteration = 0;
+
+    while(std::chrono::steady_clock::now() < deadline){
+        impl::concurrent_queue_backoff(iteration);
+        if(_try_pop(res)){
+            break;
+        }
+    }
+    return res;
+}
+
+template<typename T, typename ThreadModel>
+inline optional<T> concurrent_queue_ring_mpmc<T, ThreadModel>::try_pop(){
+    optional<T> res;
+    _try_pop(res);
+    return res;
+}
+
+
+template<typename T, typename ThreadModel>
+bool concurrent_queue_ring_mpmc<T, ThreadModel>::empty() const{
+    return size() == 0;
+}
+
+template<typename T, typename ThreadModel>
+std::size_t concurrent_queue_ring_mpmc<T, ThreadModel>::size() const{
+    // approximation under concurrent access
+    const std::size_t dequeue_pos = _dequeue_pos.load(std::memory_order_acquire);
+    const std::size_t enqueue_pos = _enqueue_pos.load(std::memory_order_acquire);
+    return (enqueue_pos > dequeue_pos) ? (enqueue_pos - dequeue_pos) : 0;
+}
+
+template<typename T, typename ThreadModel>
+std::size_t concurrent_queue_ring_mpmc<T, ThreadModel>::capacity() const{
+    return _mask + 1;
+}
+
+
+
+
+//
+// single producer / single consumer
+//
+
+template<typename T, typename ThreadModel>
+inline concurrent_queue_ring_spsc<T, ThreadModel>::concurrent_queue_ring_spsc(std::size_t capacity) :
+    _mask(impl::concurrent_queue_round_capacity(capacity) - 1),
+    _buffer(new storage_type[_mask + 1]),
+    _tail(0),
+    _head_cache(0),
+    _head(0),
+    _tail_cache(0)
+{
+
+}
+
+template<typename T, typename ThreadModel>
+inline concurrent_queue_ring_spsc<T, ThreadModel>::~concurrent_queue_ring_spsc(){
+    // destroy the remaining elements
+    optional<T> res;
+    while(_try_pop(res)){}
+}
+
+
+template<typename T, typename ThreadModel>
+template<typename U>
+inline bool concurrent_queue_ring_spsc<T, ThreadModel>::_try_emplace(U && element){
+    const std::size_t tail = _tail.load(std::memory_order_relaxed);
+
+    if(tail - _head_cache > _mask){
+        _head_cache = _head.load(std::memory_order_acquire);
+        if(tail - _head_cache > _mask){
+            // full
+            return false;
+        }
+    }
+
+    new (_elem(tail)) T(std::forward<U>(element));
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+
+template<typename T, typename ThreadModel>
+inline bool concurrent_queue_ring_spsc<T, ThreadModel>::_try_pop(optional<T> & res){
+    const std::size_t head = _head.load(std::memory_order_relaxed);
+
+    if(head == _tail_cache){
+        _tail_cache = _tail.load(std::memory_order_acquire);
+        if(head == _tail_cache){
+            // empty
+            return false;
+        }
+    }
+
+    T* elem = _elem(head);
+    res = std::move(*elem);
+    elem->~T();
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+
+template<typename T, typename ThreadModel>
+inline void concurrent_queue_ring_spsc<T, ThreadModel>::push(T element){
+    std::size_t iteration = 0;
+    while(_try_emplace(std::move(element)) == false){
+        impl::concurrent_queue_backoff(iteration);
+    }
+}
+
+template<typename T, typename ThreadModel>
+inline bool concurrent_queue_ring_spsc<T, ThreadModel>::try_push(T && element){
+    return _try_emplace(std::move(element));
+}
+
+template<typename T, typename ThreadModel>
+inline bool concurrent_queue_ring_spsc<T, ThreadModel>::try_push(const T & element){
+    return _try_emplace(element);
+}
+
+
+template<typename T, typename ThreadModel>
+template<typename InputIterator>
+inline void concurrent_queue_ring_spsc<T, ThreadModel>::push_n(InputIterator first, std::size_t n){
+    std::size_t iteration = 0;
+
+    while(n > 0){
+        const std::size_t tail = _tail.load(std::memory_order_relaxed);
+        std::size_t free_slots = _mask + 1 - (tail - _head_cache);
+
+        if(free_slots < n){
+            _head_cache = _head.load(std::memory_order_acquire);
+            free_slots = _mask + 1 - (tail - _head_cache);
+        }
+
+        if(free_slots == 0){
+            impl::concurrent_queue_backoff(iteration);
+            continue;
+        }
+
+        // publish the whole batch at once
+        const std::size_t batch = std::min(free_slots, n);
+        for(std::size_t i = 0; i < batch; ++i, ++first){
+            new (_elem(tail + i)) T(*first);
+        }
+        _tail.store(tail + batch, std::memory_order_release);
+
+        n -= batch;
+        iteration = 0;
+    }
+}
+
+
+template<typename T, typename ThreadModel>
+template<typename Duration>
+inline optional<T> concurrent_queue_ring_spsc<T, ThreadModel>::try_pop(const Duration & d){
+    optional<T> res;
+
+    if(_try_pop(res)){
+        return res;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + d;
+    std::size_t iteration = 0;
+
+    while(std::chrono::steady_clock::now() < deadline){
+        impl::concurrent_queue_backoff(iteration);
+        if(_try_pop(res)){
+            break;
+        }
+    }
+    return res;
+}
+
+template<typename T, typename ThreadModel>
+inline optional<T> concurrent_queue_ring_spsc<T, ThreadModel>::try_pop(){
+    optional<T> res;
+    _try_pop(res);
+    return res;
+}
+
+
+template<typename T, typename ThreadModel>
+template<typename OutputIterator>
+inline std::size_t concurrent_queue_ring_spsc<T, ThreadModel>::try_pop_n(OutputIterator out, std::size_t n){
+    const std::size_t head = _head.load(std::memory_order_relaxed);
+
+    if(_tail_cache - head < n){
+        _tail_cache = _tail.load(std::memory_order_acquire);
+    }
+
+    // release the whole batch at once
+    const std::size_t batch = std::min(_tail_cache - head, n);
+    for(std::size_t i = 0; i < batch; ++i, ++out){
+        T* elem = _elem(head + i);
+        *out = std::move(*elem);
+        elem->~T();
+    }
+    _head.store(head + batch, std::memory_order_release);
+
+    return batch;
+}
+
+
+template<typename T, typename ThreadModel>
+bool concurrent_queue_ring_spsc<T, ThreadModel>::empty() const{
+    return size() == 0;
+}
+
+template<typename T, typename ThreadModel>
+std::size_t concurrent_queue_ring_spsc<T, ThreadModel>::size() const{
+    // approximation under concurrent access
+    const std::size_t head = _head.load(std::memory_order_acquire);
+    const std::size_t tail = _tail.load(std::memory_order_acquire);
+    return (tail > head) ? (tail - head) : 0;
+}
+
+template<typename T, typename ThreadModel>
+std::size_t concurrent_queue_ring_spsc<T, ThreadModel>::capacity() const{
+    return _mask + 1;
+}
+
+
+
+//
+// multi producer / single consumer
+//
+
+template<typename T, typename ThreadModel>
+inline concurrent_queue_ring_mpsc<T, ThreadModel>::concurrent_queue_ring_mpsc(std::size_t capacity) :
+    _mask(impl::concurrent_queue_round_capacity(capacity) - 1),
+    _cells(new cell[_mask + 1]),
+    _enqueue_pos(0),
+    _dequeue_pos(0)
+{
+    for(std::size_t i = 0; i <= _mask; ++i){
+        _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template<typename T, typename ThreadModel>
+inline concurrent_queue_ring_mpsc<T, ThreadModel>::~concurrent_queue_ring_mpsc(){
+    // destroy the remaining elements
+    optional<T> res;
+    while(_try_pop(res)){}
+}
+
+
+template<typename T, typename ThreadModel>
+template<typename U>
+inline bool concurrent_queue_ring_mpsc<T, ThreadModel>::_try_emplace(U && element){
+    std::size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+
+    while(1){
+        cell & c = _cells[pos & _mask];
+        const std::size_t seq = c.sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos);
+
+        if(diff == 0){
+            if(_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                new (&c.storage) T(std::forward<U>(element));
+                c.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }else if(diff < 0){
+            // full
+            return false;
+        }else{
+            pos = _enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+
+template<typename T, typename ThreadModel>
+template<typename InputIterator>
+inline std::size_t concurrent_queue_ring_mpsc<T, ThreadModel>::_try_emplace_n(InputIterator & first, std::size_t n){
+    n = std::min(n, _mask + 1);
+    std::size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+
+    while(1){
+        // the single consumer frees the cells in order:
+        // if the last cell of the batch is free, all of them are
+        cell & last = _cells[(pos + n - 1) & _mask];
+        const std::size_t seq = last.sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos + n - 1);
+
+        if(diff == 0){
+            if(_enqueue_pos.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)){
+                for(std::size_t i = 0; i < n; ++i, ++first){
+                    cell & c = _cells[(pos + i) & _mask];
+                    new (&c.storage) T(*first);
+                    c.sequence.store(pos + i + 1, std::memory_order_release);
+                }
+                return n;
+            }
+        }else if(diff < 0){
+            // not enough free slots
+            return 0;
+        }else{
+            pos = _enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+
+template<typename T, typename ThreadModel>
+inline bool concurrent_queue_ring_mpsc<T, ThreadModel>::_try_pop(optional<T> & res){
+    const std::size_t pos = _dequeue_pos.load(std::memory_order_relaxed);
+    cell & c = _cells[pos & _mask];
+
+    if(c.sequence.load(std::memory_order_acquire) != pos + 1){
+        // empty
+        return false;
+    }
+
+    T* elem = reinterpret_cast<T*>(&c.storage);
+    res = std::move(*elem);
+    elem->~T();
+    c.sequence.store(pos + _mask + 1, std::memory_order_release);
+    _dequeue_pos.store(pos + 1, std::memory_order_relaxed);
+    return true;
+}
+
+
+template<typename T, typename ThreadModel>
+inline void concurrent_queue_ring_mpsc<T, ThreadModel>::push(T element){
+    std::size_t iteration = 0;
+    while(_try_emplace(std::move(element)) == false){
+        impl::concurrent_queue_backoff(iteration);
+    }
+}
+
+template<typename T, typename ThreadModel>
+inline bool concurrent_queue_ring_mpsc<T, ThreadModel>::try_push(T && element){
+    return _try_emplace(std::move(element));
+}
+
+template<typename T, typename ThreadModel>
+inline bool concurrent_queue_ring_mpsc<T, ThreadModel>::try_push(const T & element){
+    return _try_emplace(element);
+}
+
+
+template<typename T, typename ThreadModel>
+template<typename InputIterator>
+inline void concurrent_queue_ring_mpsc<T, ThreadModel>::push_n(InputIterator first, std::size_t n){
+    std::size_t iteration = 0;
+
+    while(n > 0){
+        const std::size_t pushed = _try_emplace_n(first, n);
+        if(pushed == 0){
+            impl::concurrent_queue_backoff(iteration);
+            continue;
+        }
+        n -= pushed;
+        iteration = 0;
+    }
+}
+
+
+template<typename T, typename ThreadModel>
+template<typename Duration>
+inline optional<T> concurrent_queue_ring_mpsc<T, ThreadModel>::try_pop(const Duration & d){
+    optional<T> res;
+
+    if(_try_pop(res)){
+        return res;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + d;
+    std::size_t iteration = 0;
+
+    while(std::chrono::steady_clock::now() < deadline){
+        impl::concurrent_queue_backoff(iteration);
+        if(_try_pop(res)){
+            break;
+        }
+    }
+    return res;
+}
+
+template<typename T, typename ThreadModel>
+inline optional<T> concurrent_queue_ring_mpsc<T, ThreadModel>::try_pop(){
+    optional<T> res;
+    _try_pop(res);
+    return res;
+}
+
+
+template<typename T, typename ThreadModel>
+template<typename OutputIterator>
+inline std::size_t concurrent_queue_ring_mpsc<T, ThreadModel>::try_pop_n(OutputIterator out, std::size_t n){
+    const std::size_t pos = _dequeue_pos.load(std::memory_order_relaxed);
+    std::size_t i = 0;
+
+    for(; i < n; ++i, ++out){
+        cell & c = _cells[(pos + i) & _mask];
+
+        if(c.sequence.load(std::memory_order_acquire) != pos + i + 1){
+            break;
+        }
+
+        T* elem = reinterpret_cast<T*>(&c.storage);
+        *out = std::move(*elem);
+        elem->~T();
+        c.sequence.store(pos + i + _mask + 1, std::memory_order_release);
+    }
+
+    _dequeue_pos.store(pos + i, std::memory_order_relaxed);
+    return i;
+}
+
+
+template<typename T, typename ThreadModel>
+bool concurrent_queue_ring_mpsc<T, ThreadModel>::empty() const{
+    return size() == 0;
+}
+
+template<typename T, typename ThreadModel>
+std::size_t concurrent_queue_ring_mpsc<T, ThreadModel>::size() const{
+    // approximation under concurrent access
+    const std::size_t dequeue_pos = _dequeue_pos.load(std::memory_order_acquire);
+    const std::size_t enqueue_pos = _enqueue_pos.load(std::memory_order_acquire);
+    return (enqueue_pos > dequeue_pos) ? (enqueue_pos - dequeue_pos) : 0;
+}
+
+template<typename T, typename ThreadModel>
+std::size_t concurrent_queue_ring_mpsc<T, ThreadModel>::capacity() const{
+    return _mask + 1;
+}
+
+
 } // namespace hadoken
 
 #endif // CONCURRENT_QUEUE_HPP
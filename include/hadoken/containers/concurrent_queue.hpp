@@ -29,17 +29,32 @@
 #ifndef CONCURRENT_QUEUE_HPP
 #define CONCURRENT_QUEUE_HPP
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <deque>
 #include <memory>
+#include <type_traits>
 
 
+#include <hadoken/config/platform_config.hpp>
 #include <hadoken/utility/optional.hpp>
 #include <hadoken/threading/std_thread_model.hpp>
 
 namespace hadoken {
 
+namespace impl{
+
+// ring buffer cell of the lock-free queues
+template<typename T>
+struct concurrent_queue_cell{
+    std::atomic<std::size_t> sequence;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+};
+
+} // impl
+
+
 ///
 /// simple thread-safe queue around STL container
 ///
@@ -71,8 +86,227 @@ private:
 
 
 
+///
+/// lock-free bounded multi-producer / multi-consumer queue
+///
+/// ring buffer of fixed capacity ( rounded to the next power of 2 ),
+/// no allocation is done after construction.
+/// push() waits for a free slot when the queue is full
+///
+template<typename T, typename ThreadModel = std_thread_model>
+class concurrent_queue_ring_mpmc
+{
+public:
+    explicit concurrent_queue_ring_mpmc(std::size_t capacity = 1024);
+
+    ~concurrent_queue_ring_mpmc();
+
+    void push(T element);
+
+    bool try_push(T && element);
+
+    bool try_push(const T & element);
+
+
+    template<typename Duration >
+    optional<T> try_pop(const Duration & d);
+
+    optional<T> try_pop();
+
+
+    bool empty() const;
+
+    std::size_t size() const;
+
+    std::size_t capacity() const;
+
+private:
+    typedef impl::concurrent_queue_cell<T> cell;
+
+    template<typename U>
+    bool _try_emplace(U && element);
+
+    bool _try_pop(optional<T> & res);
+
+    concurrent_queue_ring_mpmc(const concurrent_queue_ring_mpmc &) = delete;
+    concurrent_queue_ring_mpmc & operator=(const concurrent_queue_ring_mpmc &) = delete;
+
+    const std::size_t _mask;
+    std::unique_ptr<cell[]> _cells;
+
+    char _pad0[HADOKEN_CACHE_LINE_SIZE];
+    std::atomic<std::size_t> _enqueue_pos;
+    char _pad1[HADOKEN_CACHE_LINE_SIZE - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> _dequeue_pos;
+    char _pad2[HADOKEN_CACHE_LINE_SIZE - sizeof(std::atomic<std::size_t>)];
+};
+
+
+
+///
+/// lock-free bounded single-producer / single-consumer queue
+///
+/// ring buffer of fixed capacity ( rounded to the next power of 2 ),
+/// push and pop operations are wait-free when the queue is not full / not empty.
+///
+/// push* must be called by a single producer thread at a time,
+/// try_pop* by a single consumer thread at a time
+///
+template<typename T, typename ThreadModel = std_thread_model>
+class concurrent_queue_ring_spsc
+{
+public:
+    explicit concurrent_queue_ring_spsc(std::size_t capacity = 1024);
+
+    ~concurrent_queue_ring_spsc();
+
+    void push(T element);
+
+    bool try_push(T && element);
+
+    bool try_push(const T & element);
+
+    /// push n elements from first, wait for free slots when the queue is full
+    template<typename InputIterator>
+    void push_n(InputIterator first, std::size_t n);
+
+
+    template<typename Duration >
+    optional<T> try_pop(const Duration & d);
+
+    optional<T> try_pop();
+
+    /// pop up to n elements to out, return the number of elements popped
+    template<typename OutputIterator>
+    std::size_t try_pop_n(OutputIterator out, std::size_t n);
+
+
+    bool empty() const;
+
+    std::size_t size() const;
+
+    std::size_t capacity() const;
+
+private:
+    typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type storage_type;
+
+    template<typename U>
+    bool _try_emplace(U && element);
+
+    bool _try_pop(optional<T> & res);
+
+    inline T* _elem(std::size_t pos){
+        return reinterpret_cast<T*>(&_buffer[pos & _mask]);
+    }
+
+    concurrent_queue_ring_spsc(const concurrent_queue_ring_spsc &) = delete;
+    concurrent_queue_ring_spsc & operator=(const concurrent_queue_ring_spsc &) = delete;
+
+    const std::size_t _mask;
+    std::unique_ptr<storage_type[]> _buffer;
+
+    // producer side
+    char _pad0[HADOKEN_CACHE_LINE_SIZE];
+    std::atomic<std::size_t> _tail;
+    std::size_t _head_cache;
+    char _pad1[HADOKEN_CACHE_LINE_SIZE - sizeof(std::atomic<std::size_t>) - sizeof(std::size_t)];
+
+    // consumer side
+    std::atomic<std::size_t> _head;
+    std::size_t _tail_cache;
+    char _pad2[HADOKEN_CACHE_LINE_SIZE - sizeof(std::atomic<std::size_t>) - sizeof(std::size_t)];
+};
+
+
+
+///
+/// lock-free bounded multi-producer / single-consumer queue
+///
+/// ring buffer of fixed capacity ( rounded to the next power of 2 ),
+/// producers claim slots with a single atomic operation,
+/// the consumer side is wait-free when the queue is not empty.
+///
+/// try_pop* must be called by a single consumer thread at a time
+///
+template<typename T, typename ThreadModel = std_thread_model>
+class concurrent_queue_ring_mpsc
+{
+public:
+    explicit concurrent_queue_ring_mpsc(std::size_t capacity = 1024);
+
+    ~concurrent_queue_ring_mpsc();
+
+    void push(T element);
+
+    bool try_push(T && element);
+
+    bool try_push(const T & element);
+
+    /// push n elements from first, wait for free slots when the queue is full
+    /// elements of a same batch are consecutive in the queue
+    /// if n <= capacity()
+    template<typename InputIterator>
+    void push_n(InputIterator first, std::size_t n);
+
+
+    template<typename Duration >
+    optional<T> try_pop(const Duration & d);
+
+    optional<T> try_pop();
+
+    /// pop up to n elements to out, return the number of elements popped
+    template<typename OutputIterator>
+    std::size_t try_pop_n(OutputIterator out, std::size_t n);
+
+
+    bool empty() const;
+
+    std::size_t size() const;
+
+    std::size_t capacity() const;
+
+private:
+    typedef impl::concurrent_queue_cell<T> cell;
+
+    template<typename U>
+    bool _try_emplace(U && element);
+
+    template<typename InputIterator>
+    std::size_t _try_emplace_n(InputIterator & first, std::size_t n);
+
+    bool _try_pop(optional<T> & res);
+
+    concurrent_queue_ring_mpsc(const concurrent_queue_ring_mpsc &) = delete;
+    concurrent_queue_ring_mpsc & operator=(const concurrent_queue_ring_mpsc &) = delete;
+
+    const std::size_t _mask;
+    std::unique_ptr<cell[]> _cells;
+
+    char _pad0[HADOKEN_CACHE_LINE_SIZE];
+    std::atomic<std::size_t> _enqueue_pos;
+    char _pad1[HADOKEN_CACHE_LINE_SIZE - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> _dequeue_pos;
+    char _pad2[HADOKEN_CACHE_LINE_SIZE - sizeof(std::atomic<std::size_t>)];
+};
+
+
+
+///
+/// concurrent_queue type used for a given thread model
+///
+template<typename T, typename ThreadModel>
+struct concurrent_queue_selector{
+    typedef concurrent_queue_stl_mut<T, ThreadModel> type;
+};
+
 template<typename T>
-using concurrent_queue = concurrent_queue_stl_mut<T>;
+struct concurrent_queue_selector<T, std_lockfree_thread_model>{
+    typedef concurrent_queue_ring_mpmc<T, std_lockfree_thread_model> type;
+};
+
+
+template<typename T, typename ThreadModel = std_thread_model>
+using concurrent_queue = typename concurrent_queue_selector<T, ThreadModel>::type;
 
 } // namespace hadoken
 
@@ -0,0 +1,289 @@
+/**
+ * Copyright (c) 2018, Adrien Devresse <adrien.devresse@epfl.ch>
+ * 
+ * Boost Software License - Version 1.0 
+ * 
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ * 
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+* 
+*/
+#ifndef _HADOKEN_CRYPTO_FAST_HASH_IMPL_HPP_
+#define _HADOKEN_CRYPTO_FAST_HASH_IMPL_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+//
+// cores of the non-cryptographic hash functions
+//
+//  - xxh64: XXH64 from the xxHash family, https://github.com/Cyan4973/xxHash
+//  - murmur3_x64_128: MurmurHash3_x64_128, https://github.com/aappleby/smhasher
+//
+// the results are identical to the reference implementations,
+// input bytes are read as little endian words on every platform
+//
+
+namespace hadoken{
+
+namespace crypto{
+
+namespace impl{
+
+
+inline std::uint64_t fast_hash_read64(const std::uint8_t* p){
+#if (defined __BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+#else
+    return std::uint64_t(p[0]) | (std::uint64_t(p[1]) << 8) | (std::uint64_t(p[2]) << 16) | (std::uint64_t(p[3]) << 24)
+            | (std::uint64_t(p[4]) << 32) | (std::uint64_t(p[5]) << 40) | (std::uint64_t(p[6]) << 48) | (std::uint64_t(p[7]) << 56);
+#endif
+}
+
+inline std::uint32_t fast_hash_read32(const std::uint8_t* p){
+#if (defined __BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+#else
+    return std::uint32_t(p[0]) | (std::uint32_t(p[1]) << 8) | (std::uint32_t(p[2]) << 16) | (std::uint32_t(p[3]) << 24);
+#endif
+}
+
+constexpr std::uint64_t fast_hash_rotl64(std::uint64_t x, int r){
+    return (x << r) | (x >> (64 - r));
+}
+
+
+//
+// XXH64
+//
+
+constexpr std::uint64_t xxh64_prime1 = 11400714785074694791ULL;
+constexpr std::uint64_t xxh64_prime2 = 14029467366897019727ULL;
+constexpr std::uint64_t xxh64_prime3 = 1609587929392839161ULL;
+constexpr std::uint64_t xxh64_prime4 = 9650029242287828579ULL;
+constexpr std::uint64_t xxh64_prime5 = 2870177450012600261ULL;
+
+constexpr std::uint64_t xxh64_round(std::uint64_t acc, std::uint64_t input){
+    return fast_hash_rotl64(acc + input * xxh64_prime2, 31) * xxh64_prime1;
+}
+
+constexpr std::uint64_t xxh64_merge_round(std::uint64_t acc, std::uint64_t val){
+    return (acc ^ xxh64_round(0, val)) * xxh64_prime1 + xxh64_prime4;
+}
+
+constexpr std::uint64_t xxh64_converge(std::uint64_t v1, std::uint64_t v2, std::uint64_t v3, std::uint64_t v4){
+    return xxh64_merge_round(xxh64_merge_round(xxh64_merge_round(xxh64_merge_round(
+                fast_hash_rotl64(v1, 1) + fast_hash_rotl64(v2, 7) + fast_hash_rotl64(v3, 12) + fast_hash_rotl64(v4, 18),
+                v1), v2), v3), v4);
+}
+
+constexpr std::uint64_t xxh64_avalanche_step3(std::uint64_t h){
+    return h ^ (h >> 32);
+}
+
+constexpr std::uint64_t xxh64_avalanche_step2(std::uint64_t h){
+    return xxh64_avalanche_step3((h ^ (h >> 29)) * xxh64_prime3);
+}
+
+constexpr std::uint64_t xxh64_avalanche(std::uint64_t h){
+    return xxh64_avalanche_step2((h ^ (h >> 33)) * xxh64_prime2);
+}
+
+
+// constexpr ( C++11 ) version, single expression recursive functions
+
+constexpr std::uint64_t xxh64_c_read64(const char* p){
+    return std::uint64_t(std::uint8_t(p[0])) | (std::uint64_t(std::uint8_t(p[1])) << 8)
+            | (std::uint64_t(std::uint8_t(p[2])) << 16) | (std::uint64_t(std::uint8_t(p[3])) << 24)
+            | (std::uint64_t(std::uint8_t(p[4])) << 32) | (std::uint64_t(std::uint8_t(p[5])) << 40)
+            | (std::uint64_t(std::uint8_t(p[6])) << 48) | (std::uint64_t(std::uint8_t(p[7])) << 56);
+}
+
+constexpr std::uint64_t xxh64_c_read32(const char* p){
+    return std::uint64_t(std::uint8_t(p[0])) | (std::uint64_t(std::uint8_t(p[1])) << 8)
+            | (std::uint64_t(std::uint8_t(p[2])) << 16) | (std::uint64_t(std::uint8_t(p[3])) << 24);
+}
+
+constexpr std::uint64_t xxh64_c_stripes(const char* p, std::size_t n_stripes, std::uint64_t v1, std::uint64_t v2, std::uint64_t v3, std::uint64_t v4){
+    return (n_stripes == 0) ? xxh64_converge(v1, v2, v3, v4)
+                            : xxh64_c_stripes(p + 32, n_stripes - 1,
+                                              xxh64_round(v1, xxh64_c_read64(p)), xxh64_round(v2, xxh64_c_read64(p + 8)),
+                                              xxh64_round(v3, xxh64_c_read64(p + 16)), xxh64_round(v4, xxh64_c_read64(p + 24)));
+}
+
+constexpr std::uint64_t xxh64_c_tail(const char* p, std::size_t len, std::uint64_t h){
+    return (len >= 8) ? xxh64_c_tail(p + 8, len - 8, fast_hash_rotl64(h ^ xxh64_round(0, xxh64_c_read64(p)), 27) * xxh64_prime1 + xxh64_prime4)
+         : (len >= 4) ? xxh64_c_tail(p + 4, len - 4, fast_hash_rotl64(h ^ (xxh64_c_read32(p) * xxh64_prime1), 23) * xxh64_prime2 + xxh64_prime3)
+         : (len >= 1) ? xxh64_c_tail(p + 1, len - 1, fast_hash_rotl64(h ^ (std::uint64_t(std::uint8_t(p[0])) * xxh64_prime5), 11) * xxh64_prime1)
+         : xxh64_avalanche(h);
+}
+
+constexpr std::uint64_t xxh64_c(const char* p, std::size_t len, std::uint64_t seed){
+    return xxh64_c_tail(p + (len & ~std::size_t(31)), len & 31,
+                        ((len >= 32) ? xxh64_c_stripes(p, len / 32, seed + xxh64_prime1 + xxh64_prime2, seed + xxh64_prime2, seed, seed - xxh64_prime1)
+                                     : seed + xxh64_prime5) + std::uint64_t(len));
+}
+
+
+// runtime version
+
+/// consume the complete 32 bytes stripes of [p, p + len), return the number of bytes consumed
+///
+/// the 4 accumulators are independent: the stripes are processed
+/// by 4 parallel multiply chains
+inline std::size_t xxh64_stripes(const std::uint8_t* p, std::size_t len, std::uint64_t* v){
+    std::uint64_t v1 = v[0], v2 = v[1], v3 = v[2], v4 = v[3];
+
+    const std::uint8_t* const start = p;
+    const std::uint8_t* const limit = p + (len & ~std::size_t(31));
+
+    for(; p < limit; p += 32){
+        v1 = xxh64_round(v1, fast_hash_read64(p));
+        v2 = xxh64_round(v2, fast_hash_read64(p + 8));
+        v3 = xxh64_round(v3, fast_hash_read64(p + 16));
+        v4 = xxh64_round(v4, fast_hash_read64(p + 24));
+    }
+
+    v[0] = v1; v[1] = v2; v[2] = v3; v[3] = v4;
+    return static_cast<std::size_t>(p - start);
+}
+
+inline std::uint64_t xxh64_finalize(std::uint64_t h, const std::uint8_t* p, std::size_t len){
+    for(; len >= 8; len -= 8, p += 8){
+        h = fast_hash_rotl64(h ^ xxh64_round(0, fast_hash_read64(p)), 27) * xxh64_prime1 + xxh64_prime4;
+    }
+    if(len >= 4){
+        h = fast_hash_rotl64(h ^ (std::uint64_t(fast_hash_read32(p)) * xxh64_prime1), 23) * xxh64_prime2 + xxh64_prime3;
+        len -= 4;
+        p += 4;
+    }
+    for(; len > 0; --len, ++p){
+        h = fast_hash_rotl64(h ^ (std::uint64_t(*p) * xxh64_prime5), 11) * xxh64_prime1;
+    }
+    return xxh64_avalanche(h);
+}
+
+inline std::uint64_t xxh64(const void* data, std::size_t len, std::uint64_t seed){
+    const std::uint8_t* p = static_cast<const std::uint8_t*>(data);
+    std::uint64_t h;
+
+    if(len >= 32){
+        std::uint64_t v[4] = { seed + xxh64_prime1 + xxh64_prime2, seed + xxh64_prime2, seed, seed - xxh64_prime1 };
+        const std::size_t consumed = xxh64_stripes(p, len, v);
+        h = xxh64_converge(v[0], v[1], v[2], v[3]);
+        p += consumed;
+    }else{
+        h = seed + xxh64_prime5;
+    }
+
+    return xxh64_finalize(h + std::uint64_t(len), p, len & 31);
+}
+
+
+//
+// MurmurHash3_x64_128
+//
+
+constexpr std::uint64_t murmur3_c1 = 0x87c37b91114253d5ULL;
+constexpr std::uint64_t murmur3_c2 = 0x4cf5ad432745937fULL;
+
+inline std::uint64_t murmur3_fmix64(std::uint64_t k){
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+/// consume the complete 16 bytes blocks of [p, p + len), return the number of bytes consumed
+inline std::size_t murmur3_blocks(const std::uint8_t* p, std::size_t len, std::uint64_t & h1, std::uint64_t & h2){
+    const std::size_t n_blocks = len / 16;
+
+    for(std::size_t i = 0; i < n_blocks; ++i, p += 16){
+        std::uint64_t k1 = fast_hash_read64(p);
+        std::uint64_t k2 = fast_hash_read64(p + 8);
+
+        k1 *= murmur3_c1; k1 = fast_hash_rotl64(k1, 31); k1 *= murmur3_c2; h1 ^= k1;
+        h1 = fast_hash_rotl64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+
+        k2 *= murmur3_c2; k2 = fast_hash_rotl64(k2, 33); k2 *= murmur3_c1; h2 ^= k2;
+        h2 = fast_hash_rotl64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    return n_blocks * 16;
+}
+
+/// process the tail ( < 16 bytes ) and finalize for a message of total_len bytes
+inline std::array<std::uint64_t, 2> murmur3_finalize(std::uint64_t h1, std::uint64_t h2, const std::uint8_t* tail, std::size_t tail_len, std::uint64_t total_len){
+    std::uint64_t k1 = 0, k2 = 0;
+
+    for(std::size_t i = tail_len; i > 8; --i){
+        k2 ^= std::uint64_t(tail[i - 1]) << ((i - 9) * 8);
+    }
+    if(tail_len > 8){
+        k2 *= murmur3_c2; k2 = fast_hash_rotl64(k2, 33); k2 *= murmur3_c1; h2 ^= k2;
+    }
+
+    for(std::size_t i = (tail_len > 8 ? 8 : tail_len); i > 0; --i){
+        k1 ^= std::uint64_t(tail[i - 1]) << ((i - 1) * 8);
+    }
+    if(tail_len > 0){
+        k1 *= murmur3_c1; k1 = fast_hash_rotl64(k1, 31); k1 *= murmur3_c2; h1 ^= k1;
+    }
+
+    h1 ^= total_len;
+    h2 ^= total_len;
+
+    h1 += h2;
+    h2 += h1;
+
+    h1 = murmur3_fmix64(h1);
+    h2 = murmur3_fmix64(h2);
+
+    h1 += h2;
+    h2 += h1;
+
+    return std::array<std::uint64_t, 2>{ { h1, h2 } };
+}
+
+inline std::array<std::uint64_t, 2> murmur3_x64_128(const void* data, std::size_t len, std::uint32_t seed){
+    const std::uint8_t* p = static_cast<const std::uint8_t*>(data);
+    std::uint64_t h1 = seed, h2 = seed;
+
+    const std::size_t consumed = murmur3_blocks(p, len, h1, h2);
+    return murmur3_finalize(h1, h2, p + consumed, len - consumed, len);
+}
+
+
+} // impl
+
+} // crypto
+
+} // hadoken
+
+#endif // _HADOKEN_CRYPTO_FAST_HASH_IMPL_HPP_
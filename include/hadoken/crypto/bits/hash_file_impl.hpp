@@ -0,0 +1,411 @@
+/**
+ * Copyright (c) 2018, Adrien Devresse <adrien.devresse@epfl.ch>
+ * 
+ * Boost Software License - Version 1.0 
+ * 
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ * 
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+* 
+*/
+#ifndef _HADOKEN_CRYPTO_HASH_FILE_IMPL_HPP_
+#define _HADOKEN_CRYPTO_HASH_FILE_IMPL_HPP_
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <future>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <hadoken/parallel/algorithm.hpp>
+
+#if (defined __unix__ || defined __APPLE__)
+#   define HADOKEN_HASH_FILE_POSIX 1
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#else
+#   include <fstream>
+#endif
+
+
+namespace hadoken{
+
+namespace crypto{
+
+namespace impl{
+
+
+// size of the read() buffers
+constexpr std::size_t hash_file_buffer_size = 4 * 1024 * 1024;
+
+// size of the read-ahead window of the memory mapped hashing
+constexpr std::size_t hash_file_mmap_window = 8 * 1024 * 1024;
+
+
+inline std::system_error hash_file_error(const std::string & msg, const std::string & path, int err = errno){
+    return std::system_error(err, std::generic_category(), msg + " " + path);
+}
+
+
+inline sha1::digest32_t hash_file_tree_root(const std::vector<sha1::digest32_t> & leaves){
+    sha1 root;
+    for(const sha1::digest32_t & leaf : leaves){
+        for(std::uint32_t word : leaf){
+            root.process(word);
+        }
+    }
+    return root.get_digest();
+}
+
+
+#ifdef HADOKEN_HASH_FILE_POSIX
+
+
+/// read only file descriptor
+class posix_file{
+public:
+    inline explicit posix_file(const std::string & path) : _fd(::open(path.c_str(), O_RDONLY)), _path(path){
+        if(_fd < 0){
+            throw hash_file_error("impossible to open", _path);
+        }
+
+        struct stat st;
+        if(::fstat(_fd, &st) != 0){
+            const int err = errno;
+            ::close(_fd);
+            throw hash_file_error("impossible to stat", _path, err);
+        }
+        _regular = S_ISREG(st.st_mode);
+        _size = _regular ? static_cast<std::size_t>(st.st_size) : 0;
+    }
+
+    inline ~posix_file(){
+        ::close(_fd);
+    }
+
+    posix_file(const posix_file &) = delete;
+    posix_file & operator=(const posix_file &) = delete;
+
+    inline int fd() const{
+        return _fd;
+    }
+
+    inline bool is_regular() const{
+        return _regular;
+    }
+
+    /// size of a regular file, 0 otherwise
+    inline std::size_t size() const{
+        return _size;
+    }
+
+    inline const std::string & path() const{
+        return _path;
+    }
+
+    inline void advise_sequential() const{
+#ifdef POSIX_FADV_SEQUENTIAL
+        (void) ::posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    }
+
+    /// read up to len bytes from the current position, return 0 at the end of file
+    inline std::size_t read(void* buffer, std::size_t len) const{
+        std::size_t n_read = 0;
+        while(n_read < len){
+            const ssize_t res = ::read(_fd, static_cast<char*>(buffer) + n_read, len - n_read);
+            if(res < 0){
+                if(errno == EINTR){
+                    continue;
+                }
+                throw hash_file_error("error while reading", _path);
+            }
+            if(res == 0){
+                break;
+            }
+            n_read += static_cast<std::size_t>(res);
+        }
+        return n_read;
+    }
+
+    /// read up to len bytes from offset, return 0 at the end of file
+    inline std::size_t pread(void* buffer, std::size_t len, std::size_t offset) const{
+        std::size_t n_read = 0;
+        while(n_read < len){
+            const ssize_t res = ::pread(_fd, static_cast<char*>(buffer) + n_read, len - n_read, static_cast<off_t>(offset + n_read));
+            if(res < 0){
+                if(errno == EINTR){
+                    continue;
+                }
+                throw hash_file_error("error while reading", _path);
+            }
+            if(res == 0){
+                break;
+            }
+            n_read += static_cast<std::size_t>(res);
+        }
+        return n_read;
+    }
+
+private:
+    int _fd;
+    bool _regular;
+    std::size_t _size;
+    std::string _path;
+};
+
+
+/// read only memory mapping of a whole file, invalid if the mapping failed
+class mapped_file{
+public:
+    inline explicit mapped_file(const posix_file & file) : _data(nullptr), _size(file.size()){
+        if(_size == 0){
+            return;
+        }
+
+        void* addr = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file.fd(), 0);
+        if(addr != MAP_FAILED){
+            _data = static_cast<const std::uint8_t*>(addr);
+        }
+    }
+
+    inline ~mapped_file(){
+        if(_data != nullptr){
+            ::munmap(const_cast<std::uint8_t*>(_data), _size);
+        }
+    }
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file & operator=(const mapped_file &) = delete;
+
+    inline bool valid() const{
+        return _data != nullptr;
+    }
+
+    inline const std::uint8_t* data() const{
+        return _data;
+    }
+
+    inline std::size_t size() const{
+        return _size;
+    }
+
+    /// hint the kernel to load [offset, offset + len) ahead of use
+    inline void prefetch(std::size_t offset, std::size_t len) const{
+        if(offset >= _size){
+            return;
+        }
+        const std::size_t page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        const std::size_t page_offset = offset - (offset % page_size);
+        len = std::min(len, _size - offset) + (offset - page_offset);
+
+        (void) ::madvise(const_cast<std::uint8_t*>(_data) + page_offset, len, MADV_WILLNEED);
+    }
+
+    inline void advise_sequential() const{
+        (void) ::madvise(const_cast<std::uint8_t*>(_data), _size, MADV_SEQUENTIAL);
+    }
+
+private:
+    const std::uint8_t* _data;
+    std::size_t _size;
+};
+
+
+inline void hash_file_mmap(const mapped_file & map, sha1 & sha){
+    map.advise_sequential();
+    map.prefetch(0, hash_file_mmap_window);
+
+    for(std::size_t offset = 0; offset < map.size(); offset += hash_file_mmap_window){
+        // the next window is loaded by the kernel while the current one is hashed
+        map.prefetch(offset + hash_file_mmap_window, hash_file_mmap_window);
+
+        const std::size_t len = std::min(hash_file_mmap_window, map.size() - offset);
+        sha.process_block(map.data() + offset, len);
+    }
+}
+
+
+inline void hash_file_read(const posix_file & file, sha1 & sha){
+    file.advise_sequential();
+
+    std::vector<std::uint8_t> buffers[2] = {
+        std::vector<std::uint8_t>(hash_file_buffer_size),
+        std::vector<std::uint8_t>(hash_file_buffer_size)
+    };
+    std::size_t current = 0;
+    std::size_t n_read = file.read(buffers[current].data(), hash_file_buffer_size);
+
+    while(n_read > 0){
+        std::vector<std::uint8_t> & next_buffer = buffers[current ^ 1];
+        std::future<std::size_t> next_read = std::async(std::launch::async, [&file, &next_buffer](){
+            return file.read(next_buffer.data(), next_buffer.size());
+        });
+
+        sha.process_block(buffers[current].data(), n_read);
+
+        n_read = next_read.get();
+        current ^= 1;
+    }
+}
+
+
+inline sha1::digest32_t hash_file_chunk(const posix_file & file, const mapped_file & map, std::size_t offset, std::size_t len){
+    sha1 sha;
+
+    if(map.valid()){
+        sha.process_block(map.data() + offset, len);
+    }else{
+        std::vector<std::uint8_t> buffer(std::min(len, hash_file_buffer_size));
+        while(len > 0){
+            const std::size_t n_read = file.pread(buffer.data(), std::min(len, buffer.size()), offset);
+            if(n_read == 0){
+                throw hash_file_error("unexpected end of file", file.path(), EIO);
+            }
+            sha.process_block(buffer.data(), n_read);
+            offset += n_read;
+            len -= n_read;
+        }
+    }
+
+    return sha.get_digest();
+}
+
+
+#else
+
+
+inline void hash_file_stream(const std::string & path, std::size_t offset, std::size_t len, sha1 & sha){
+    std::ifstream input(path, std::ios::in | std::ios::binary);
+    if(!input){
+        throw hash_file_error("impossible to open", path, ENOENT);
+    }
+    input.seekg(static_cast<std::streamoff>(offset));
+
+    std::vector<char> buffer(hash_file_buffer_size);
+    while(len > 0 && input){
+        input.read(buffer.data(), static_cast<std::streamsize>(std::min(len, buffer.size())));
+        const std::size_t n_read = static_cast<std::size_t>(input.gcount());
+        sha.process_block(buffer.data(), n_read);
+        len -= n_read;
+    }
+
+    if(input.bad()){
+        throw hash_file_error("error while reading", path, EIO);
+    }
+}
+
+
+#endif // HADOKEN_HASH_FILE_POSIX
+
+
+} // impl
+
+
+
+inline sha1::digest32_t hash_file(const std::string & path, hash_file_method method){
+    sha1 sha;
+
+#ifdef HADOKEN_HASH_FILE_POSIX
+    impl::posix_file file(path);
+
+    if(method != hash_file_method::read && file.is_regular() && file.size() > 0){
+        impl::mapped_file map(file);
+
+        if(map.valid()){
+            impl::hash_file_mmap(map, sha);
+            return sha.get_digest();
+        }
+
+        if(method == hash_file_method::mmap){
+            throw impl::hash_file_error("impossible to map", path);
+        }
+    }
+
+    impl::hash_file_read(file, sha);
+#else
+    (void) method;
+    impl::hash_file_stream(path, 0, std::size_t(-1), sha);
+#endif
+
+    return sha.get_digest();
+}
+
+
+
+template<typename ExecPolicy>
+inline sha1::digest32_t hash_file_tree(ExecPolicy && policy, const std::string & path, std::size_t chunk_size){
+    if(chunk_size == 0){
+        throw std::invalid_argument("hash_file_tree: chunk size can not be 0");
+    }
+
+#ifdef HADOKEN_HASH_FILE_POSIX
+    impl::posix_file file(path);
+
+    if(file.is_regular() == false){
+        throw std::invalid_argument("hash_file_tree: " + path + " is not a regular file");
+    }
+
+    const std::size_t file_size = file.size();
+    impl::mapped_file map(file);
+#else
+    std::ifstream input(path, std::ios::in | std::ios::binary | std::ios::ate);
+    if(!input){
+        throw impl::hash_file_error("impossible to open", path, ENOENT);
+    }
+    const std::size_t file_size = static_cast<std::size_t>(input.tellg());
+#endif
+
+    const std::size_t n_chunks = std::max<std::size_t>(1, (file_size + chunk_size - 1) / chunk_size);
+    std::vector<sha1::digest32_t> leaves(n_chunks);
+
+    typedef std::vector<sha1::digest32_t>::iterator leaf_iterator;
+    const leaf_iterator leaves_begin = leaves.begin();
+
+    parallel::for_range(std::forward<ExecPolicy>(policy), leaves.begin(), leaves.end(), [&](leaf_iterator local_begin, leaf_iterator local_end){
+        for(leaf_iterator it = local_begin; it != local_end; ++it){
+            const std::size_t offset = static_cast<std::size_t>(std::distance(leaves_begin, it)) * chunk_size;
+            const std::size_t len = std::min(chunk_size, file_size - offset);
+
+#ifdef HADOKEN_HASH_FILE_POSIX
+            *it = impl::hash_file_chunk(file, map, offset, len);
+#else
+            sha1 sha;
+            impl::hash_file_stream(path, offset, len, sha);
+            *it = sha.get_digest();
+#endif
+        }
+    });
+
+    return impl::hash_file_tree_root(leaves);
+}
+
+
+} // crypto
+
+} // hadoken
+
+#endif // _HADOKEN_CRYPTO_HASH_FILE_IMPL_HPP_
@@ -31,5 +31,7 @@
 
 
 #include "sha/sha1.hpp"
+#include "sha/sha1_multi.hpp"
+#include "fast_hash.hpp"
 
 #endif // _HADOKEN_CRYPTO_HPP_
@@ -0,0 +1,255 @@
+/**
+ * Copyright (c) 2018, Adrien Devresse <adrien.devresse@epfl.ch>
+ * 
+ * Boost Software License - Version 1.0 
+ * 
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ * 
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+* 
+*/
+#ifndef _HADOKEN_CRYPTO_FAST_HASH_HPP_
+#define _HADOKEN_CRYPTO_FAST_HASH_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <hadoken/string/string_view.hpp>
+
+#include "bits/fast_hash_impl.hpp"
+
+//
+// fast non-cryptographic hash functions
+//
+// for hash tables, sharding, checksums of non-adversarial data
+// use hadoken::sha1 when a cryptographic hash is required
+//
+//  - 64 bits:  XXH64
+//  - 128 bits: MurmurHash3_x64_128
+//
+
+namespace hadoken{
+
+namespace crypto{
+
+
+typedef std::array<std::uint64_t, 2> hash128_t;
+
+
+///
+/// 64 bits hash of [data, data + len)
+///
+inline std::uint64_t hash64(const void* data, std::size_t len, std::uint64_t seed = 0){
+    return impl::xxh64(data, len, seed);
+}
+
+///
+/// 64 bits hash of a string, without copy
+///
+inline std::uint64_t hash64(const string_view & str, std::uint64_t seed = 0){
+    return impl::xxh64(str.data(), str.size(), seed);
+}
+
+///
+/// compile time 64 bits hash, same result than hash64
+///
+///  \code
+///    constexpr std::uint64_t key = hadoken::crypto::static_hash64("my_key");
+///    constexpr std::uint64_t seeded_key = hadoken::crypto::static_hash64("my_key", 6, 42);
+///  \endcode
+///
+constexpr std::uint64_t static_hash64(const char* str, std::size_t len, std::uint64_t seed = 0){
+    return impl::xxh64_c(str, len, seed);
+}
+
+/// compile time 64 bits hash of a string literal, without the terminating null character
+template<std::size_t N>
+constexpr std::uint64_t static_hash64(const char (&str)[N]){
+    return impl::xxh64_c(str, N - 1, 0);
+}
+
+
+///
+/// 128 bits hash of [data, data + len)
+///
+inline hash128_t hash128(const void* data, std::size_t len, std::uint32_t seed = 0){
+    return impl::murmur3_x64_128(data, len, seed);
+}
+
+///
+/// 128 bits hash of a string, without copy
+///
+inline hash128_t hash128(const string_view & str, std::uint32_t seed = 0){
+    return impl::murmur3_x64_128(str.data(), str.size(), seed);
+}
+
+
+
+///
+/// streaming 64 bits hash, same result than hash64 on the concatenation of the updates
+///
+class hasher64{
+public:
+    inline explicit hasher64(std::uint64_t seed = 0){
+        reset(seed);
+    }
+
+    inline void reset(std::uint64_t seed = 0){
+        _seed = seed;
+        _v[0] = seed + impl::xxh64_prime1 + impl::xxh64_prime2;
+        _v[1] = seed + impl::xxh64_prime2;
+        _v[2] = seed;
+        _v[3] = seed - impl::xxh64_prime1;
+        _total_len = 0;
+        _buffer_size = 0;
+    }
+
+    inline void update(const void* data, std::size_t len){
+        const std::uint8_t* p = static_cast<const std::uint8_t*>(data);
+        _total_len += len;
+
+        if(_buffer_size > 0){
+            const std::size_t n_fill = std::min(len, _buffer.size() - _buffer_size);
+            std::memcpy(&_buffer[_buffer_size], p, n_fill);
+            _buffer_size += n_fill;
+            p += n_fill;
+            len -= n_fill;
+
+            if(_buffer_size < _buffer.size()){
+                return;
+            }
+            impl::xxh64_stripes(&_buffer[0], _buffer.size(), _v);
+            _buffer_size = 0;
+        }
+
+        const std::size_t consumed = impl::xxh64_stripes(p, len, _v);
+        p += consumed;
+        len -= consumed;
+
+        if(len > 0){
+            std::memcpy(&_buffer[0], p, len);
+            _buffer_size = len;
+        }
+    }
+
+    inline void update(const string_view & str){
+        update(str.data(), str.size());
+    }
+
+    inline std::uint64_t digest() const{
+        std::uint64_t h = (_total_len >= 32) ? impl::xxh64_converge(_v[0], _v[1], _v[2], _v[3])
+                                              : _seed + impl::xxh64_prime5;
+        return impl::xxh64_finalize(h + _total_len, &_buffer[0], _buffer_size);
+    }
+
+private:
+    std::uint64_t _seed;
+    std::uint64_t _v[4];
+    std::uint64_t _total_len;
+    std::array<std::uint8_t, 32> _buffer;
+    std::size_t _buffer_size;
+};
+
+
+
+///
+/// streaming 128 bits hash, same result than hash128 on the concatenation of the updates
+///
+class hasher128{
+public:
+    inline explicit hasher128(std::uint32_t seed = 0){
+        reset(seed);
+    }
+
+    inline void reset(std::uint32_t seed = 0){
+        _h1 = seed;
+        _h2 = seed;
+        _total_len = 0;
+        _buffer_size = 0;
+    }
+
+    inline void update(const void* data, std::size_t len){
+        const std::uint8_t* p = static_cast<const std::uint8_t*>(data);
+        _total_len += len;
+
+        if(_buffer_size > 0){
+            const std::size_t n_fill = std::min(len, _buffer.size() - _buffer_size);
+            std::memcpy(&_buffer[_buffer_size], p, n_fill);
+            _buffer_size += n_fill;
+            p += n_fill;
+            len -= n_fill;
+
+            if(_buffer_size < _buffer.size()){
+                return;
+            }
+            impl::murmur3_blocks(&_buffer[0], _buffer.size(), _h1, _h2);
+            _buffer_size = 0;
+        }
+
+        const std::size_t consumed = impl::murmur3_blocks(p, len, _h1, _h2);
+        p += consumed;
+        len -= consumed;
+
+        if(len > 0){
+            std::memcpy(&_buffer[0], p, len);
+            _buffer_size = len;
+        }
+    }
+
+    inline void update(const string_view & str){
+        update(str.data(), str.size());
+    }
+
+    inline hash128_t digest() const{
+        return impl::murmur3_finalize(_h1, _h2, &_buffer[0], _buffer_size, _total_len);
+    }
+
+private:
+    std::uint64_t _h1, _h2;
+    std::uint64_t _total_len;
+    std::array<std::uint8_t, 16> _buffer;
+    std::size_t _buffer_size;
+};
+
+
+
+///
+/// hash function object for hash tables keyed by strings
+///
+///  \code
+///    std::unordered_map<std::string, int, hadoken::crypto::string_hash> map;
+///  \endcode
+///
+struct string_hash{
+    inline std::size_t operator()(const string_view & str) const{
+        return static_cast<std::size_t>(hash64(str));
+    }
+};
+
+
+} // crypto
+
+} // hadoken
+
+#endif // _HADOKEN_CRYPTO_FAST_HASH_HPP_
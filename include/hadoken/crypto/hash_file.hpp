@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2018, Adrien Devresse <adrien.devresse@epfl.ch>
+ * 
+ * Boost Software License - Version 1.0 
+ * 
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ * 
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+* 
+*/
+#ifndef _HADOKEN_CRYPTO_HASH_FILE_HPP_
+#define _HADOKEN_CRYPTO_HASH_FILE_HPP_
+
+#include <cstddef>
+#include <string>
+
+#include <hadoken/crypto/sha/sha1.hpp>
+
+
+namespace hadoken{
+
+namespace crypto{
+
+
+/// file access method used by hash_file
+enum class hash_file_method{
+    automatic,  ///< memory mapping when possible, read otherwise
+    mmap,       ///< memory mapped file, read sequentially with read-ahead hints
+    read        ///< double buffered read(), the next buffer is read while the current one is hashed
+};
+
+
+/// default size of the leaves of the tree hash
+constexpr std::size_t hash_file_tree_chunk_size = 16 * 1024 * 1024;
+
+
+///
+/// sha1 of the content of a file
+///
+/// the result is identical to a hadoken::sha1 fed with the whole file content
+///
+/// throw std::system_error if the file can not be opened or read
+///
+inline sha1::digest32_t hash_file(const std::string & path, hash_file_method method = hash_file_method::automatic);
+
+
+///
+/// parallel tree hash of a file
+///
+/// the file is split in chunks of chunk_size bytes, hashed concurrently
+/// with policy ( e.g parallel::par ). The result is the sha1 of the concatenation
+/// of the big endian chunk digests
+///
+///    tree_hash = sha1( sha1(chunk_0) | sha1(chunk_1) | ... | sha1(chunk_n) )
+///
+/// this is NOT the sha1 of the file: the digest depends on chunk_size
+/// but not on the policy or the number of executors
+///
+/// throw std::system_error if the file can not be opened or read
+///
+template<typename ExecPolicy>
+inline sha1::digest32_t hash_file_tree(ExecPolicy && policy, const std::string & path,
+                                       std::size_t chunk_size = hash_file_tree_chunk_size);
+
+
+} // crypto
+
+} // hadoken
+
+
+#include "bits/hash_file_impl.hpp"
+
+#endif // _HADOKEN_CRYPTO_HASH_FILE_HPP_
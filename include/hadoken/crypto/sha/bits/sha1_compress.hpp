@@ -0,0 +1,256 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ * 
+ * Boost Software License - Version 1.0 
+ * 
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ * 
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+* 
+*/
+#ifndef _HADOKEN_SHA1_COMPRESS_HPP_
+#define _HADOKEN_SHA1_COMPRESS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <hadoken/config/platform_config.hpp>
+
+//
+// SHA1 block compression functions
+//
+//  - sha1_compress_generic: portable implementation
+//  - sha1_compress_shani:   x86 SHA extensions ( SHA-NI ),
+//                           selected at runtime when the CPU supports it
+//
+// define HADOKEN_SHA1_NO_SHANI to disable the SHA-NI backend
+//
+
+#if (defined __x86_64__ || defined __i386__) && (defined __GNUC__ || defined __clang__) \
+    && !(defined HADOKEN_COMPILER_IS_NVCC) && !(defined HADOKEN_SHA1_NO_SHANI)
+#   define HADOKEN_SHA1_SHANI_BACKEND 1
+#   include <cpuid.h>
+#   include <immintrin.h>
+#endif
+
+
+namespace hadoken{
+
+namespace impl{
+
+
+inline std::uint32_t sha1_rotl(std::uint32_t value, unsigned int count){
+    return (value << count) | (value >> (32 - count));
+}
+
+inline std::uint32_t sha1_load_be32(const std::uint8_t* p){
+    return (std::uint32_t(p[0]) << 24) | (std::uint32_t(p[1]) << 16) | (std::uint32_t(p[2]) << 8) | std::uint32_t(p[3]);
+}
+
+
+/// portable compression of n_blocks consecutive 64 bytes blocks
+///
+/// the message schedule is kept in a 16 words circular buffer
+/// and each group of 20 rounds has its own loop: no branch per round
+inline void sha1_compress_generic(std::uint32_t* state, const std::uint8_t* data, std::size_t n_blocks){
+
+    for(; n_blocks > 0; --n_blocks, data += 64){
+        std::uint32_t w[16];
+        for(std::size_t i = 0; i < 16; ++i){
+            w[i] = sha1_load_be32(data + i * 4);
+        }
+
+        std::uint32_t a = state[0];
+        std::uint32_t b = state[1];
+        std::uint32_t c = state[2];
+        std::uint32_t d = state[3];
+        std::uint32_t e = state[4];
+
+        std::size_t i = 0;
+
+        for(; i < 20; ++i){
+            if(i >= 16){
+                w[i & 15] = sha1_rotl(w[(i-3) & 15] ^ w[(i-8) & 15] ^ w[(i-14) & 15] ^ w[i & 15], 1);
+            }
+            const std::uint32_t temp = sha1_rotl(a, 5) + ((b & c) | (~b & d)) + e + 0x5A827999 + w[i & 15];
+            e = d; d = c; c = sha1_rotl(b, 30); b = a; a = temp;
+        }
+
+        for(; i < 40; ++i){
+            w[i & 15] = sha1_rotl(w[(i-3) & 15] ^ w[(i-8) & 15] ^ w[(i-14) & 15] ^ w[i & 15], 1);
+            const std::uint32_t temp = sha1_rotl(a, 5) + (b ^ c ^ d) + e + 0x6ED9EBA1 + w[i & 15];
+            e = d; d = c; c = sha1_rotl(b, 30); b = a; a = temp;
+        }
+
+        for(; i < 60; ++i){
+            w[i & 15] = sha1_rotl(w[(i-3) & 15] ^ w[(i-8) & 15] ^ w[(i-14) & 15] ^ w[i & 15], 1);
+            const std::uint32_t temp = sha1_rotl(a, 5) + ((b & c) | (b & d) | (c & d)) + e + 0x8F1BBCDC + w[i & 15];
+            e = d; d = c; c = sha1_rotl(b, 30); b = a; a = temp;
+        }
+
+        for(; i < 80; ++i){
+            w[i & 15] = sha1_rotl(w[(i-3) & 15] ^ w[(i-8) & 15] ^ w[(i-14) & 15] ^ w[i & 15], 1);
+            const std::uint32_t temp = sha1_rotl(a, 5) + (b ^ c ^ d) + e + 0xCA62C1D6 + w[i & 15];
+            e = d; d = c; c = sha1_rotl(b, 30); b = a; a = temp;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+    }
+}
+
+
+#ifdef HADOKEN_SHA1_SHANI_BACKEND
+
+#define HADOKEN_SHA1_SHANI_TARGET __attribute__((target("sha,ssse3,sse4.1")))
+
+
+/// runtime detection of the SHA extensions ( and SSSE3 / SSE4.1 used by the backend )
+inline bool sha1_cpu_has_shani(){
+    static const bool has_shani = [](){
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+
+        if(__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0){
+            return false;
+        }
+        const bool has_ssse3 = (ecx & (1u << 9)) != 0;
+        const bool has_sse41 = (ecx & (1u << 19)) != 0;
+
+        if(__get_cpuid_max(0, nullptr) < 7){
+            return false;
+        }
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        const bool has_sha = (ebx & (1u << 29)) != 0;
+
+        return has_ssse3 && has_sse41 && has_sha;
+    }();
+
+    return has_shani;
+}
+
+
+/// one group of 4 rounds, the message schedule runs in the same group:
+/// msg[(I+1)%4], msg[(I-1)%4] and msg[(I+2)%4] are advanced from msg[I%4]
+/// E alternates between e0 (even groups) and e1 (odd groups)
+template<int I>
+HADOKEN_SHA1_SHANI_TARGET
+inline void sha1_shani_rounds4(__m128i & abcd, __m128i & e_cur, __m128i & e_next, __m128i* msg){
+    __m128i & m_cur = msg[I % 4];
+
+    if(I == 0){
+        e_cur = _mm_add_epi32(e_cur, m_cur);
+    }else{
+        e_cur = _mm_sha1nexte_epu32(e_cur, m_cur);
+    }
+    e_next = abcd;
+
+    if(I >= 3 && I <= 18){
+        msg[(I+1) % 4] = _mm_sha1msg2_epu32(msg[(I+1) % 4], m_cur);
+    }
+
+    abcd = _mm_sha1rnds4_epu32(abcd, e_cur, I / 5);
+
+    if(I >= 1 && I <= 16){
+        msg[(I+3) % 4] = _mm_sha1msg1_epu32(msg[(I+3) % 4], m_cur);
+    }
+
+    if(I >= 2 && I <= 17){
+        msg[(I+2) % 4] = _mm_xor_si128(msg[(I+2) % 4], m_cur);
+    }
+}
+
+
+template<int I>
+struct sha1_shani_groups{
+
+    HADOKEN_SHA1_SHANI_TARGET
+    static inline void run(__m128i & abcd, __m128i & e0, __m128i & e1, __m128i* msg, const std::uint8_t* data, __m128i mask){
+        if(I < 4){
+            msg[I] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + I * 16)), mask);
+        }
+
+        if(I % 2 == 0){
+            sha1_shani_rounds4<I>(abcd, e0, e1, msg);
+        }else{
+            sha1_shani_rounds4<I>(abcd, e1, e0, msg);
+        }
+
+        sha1_shani_groups<I+1>::run(abcd, e0, e1, msg, data, mask);
+    }
+};
+
+template<>
+struct sha1_shani_groups<20>{
+
+    HADOKEN_SHA1_SHANI_TARGET
+    static inline void run(__m128i &, __m128i &, __m128i &, __m128i*, const std::uint8_t*, __m128i){ }
+};
+
+
+/// compression of n_blocks consecutive 64 bytes blocks with the SHA extensions
+HADOKEN_SHA1_SHANI_TARGET
+inline void sha1_compress_shani(std::uint32_t* state, const std::uint8_t* data, std::size_t n_blocks){
+    const __m128i mask = _mm_set_epi64x(0x0001020304050607LL, 0x08090a0b0c0d0e0fLL);
+
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1B);
+    __m128i e0 = _mm_set_epi32(int(state[4]), 0, 0, 0);
+
+    for(; n_blocks > 0; --n_blocks, data += 64){
+        const __m128i abcd_save = abcd;
+        const __m128i e0_save = e0;
+        __m128i e1;
+        __m128i msg[4];
+
+        sha1_shani_groups<0>::run(abcd, e0, e1, msg, data, mask);
+
+        e0 = _mm_sha1nexte_epu32(e0, e0_save);
+        abcd = _mm_add_epi32(abcd, abcd_save);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1B));
+    state[4] = std::uint32_t(_mm_extract_epi32(e0, 3));
+}
+
+#undef HADOKEN_SHA1_SHANI_TARGET
+
+#endif // HADOKEN_SHA1_SHANI_BACKEND
+
+
+/// compress with the best backend available at runtime
+inline void sha1_compress(std::uint32_t* state, const std::uint8_t* data, std::size_t n_blocks){
+#ifdef HADOKEN_SHA1_SHANI_BACKEND
+    if(sha1_cpu_has_shani()){
+        sha1_compress_shani(state, data, n_blocks);
+        return;
+    }
+#endif
+    sha1_compress_generic(state, data, n_blocks);
+}
+
+
+} // impl
+
+} // hadoken
+
+#endif // _HADOKEN_SHA1_COMPRESS_HPP_
@@ -0,0 +1,200 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ * 
+ * Boost Software License - Version 1.0 
+ * 
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ * 
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+* 
+*/
+#ifndef _HADOKEN_SHA1_MULTI_LANES_HPP_
+#define _HADOKEN_SHA1_MULTI_LANES_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <hadoken/config/platform_config.hpp>
+
+#include "sha1_compress.hpp"
+
+//
+// SHA1 multi-buffer compression
+//
+// one 64 bytes block of Lanes independent messages is compressed at once,
+// the state of the lane l is stored in the SoA layout state[word * Lanes + l]
+//
+// the SIMD code relies on the GCC / clang vector extensions,
+// with an AVX2 version selected at runtime on x86
+//
+
+#if (defined __GNUC__ || defined __clang__) && !(defined HADOKEN_COMPILER_IS_NVCC)
+#   define HADOKEN_SHA1_VECTOR_EXTENSIONS 1
+#   define HADOKEN_SHA1_FORCE_INLINE inline __attribute__((always_inline))
+#   if (defined __x86_64__ || defined __i386__)
+#       define HADOKEN_SHA1_AVX2_BACKEND 1
+#   endif
+#endif
+
+
+namespace hadoken{
+
+namespace impl{
+
+
+/// number of lanes of the multi-buffer backends
+enum sha1_multi_lanes_count{
+    sha1_multi_lanes_avx2 = 8,
+    sha1_multi_lanes_default = 4
+};
+
+
+#ifdef HADOKEN_SHA1_VECTOR_EXTENSIONS
+
+template<std::size_t Lanes>
+struct sha1_lane_vector{
+    typedef std::uint32_t type __attribute__((vector_size(Lanes * sizeof(std::uint32_t))));
+};
+
+
+#define HADOKEN_SHA1_VROTL(v, c) (((v) << (c)) | ((v) >> (32 - (c))))
+
+#define HADOKEN_SHA1_LANES_ROUND(f, k)                                                                   \
+    {                                                                                                     \
+        const vec temp = HADOKEN_SHA1_VROTL(a, 5) + (f) + e + std::uint32_t(k) + w[i & 15];               \
+        e = d; d = c; c = HADOKEN_SHA1_VROTL(b, 30); b = a; a = temp;                                      \
+    }
+
+#define HADOKEN_SHA1_LANES_SCHEDULE()                                                                     \
+    {                                                                                                     \
+        const vec x = w[(i-3) & 15] ^ w[(i-8) & 15] ^ w[(i-14) & 15] ^ w[i & 15];                           \
+        w[i & 15] = HADOKEN_SHA1_VROTL(x, 1);                                                              \
+    }
+
+
+/// compress one block for each of the Lanes messages
+///
+/// blocks[l] points to the 64 bytes block of the lane l,
+/// lanes with a zero mask[l] keep their state unchanged
+template<std::size_t Lanes>
+HADOKEN_SHA1_FORCE_INLINE void sha1_compress_lanes_body(std::uint32_t* state, const std::uint8_t* const* blocks, const std::uint32_t* mask){
+    typedef typename sha1_lane_vector<Lanes>::type vec;
+
+    vec w[16];
+    for(std::size_t i = 0; i < 16; ++i){
+        for(std::size_t l = 0; l < Lanes; ++l){
+            w[i][l] = sha1_load_be32(blocks[l] + i * 4);
+        }
+    }
+
+    vec s[5], m;
+    std::memcpy(s, state, sizeof(s));
+    std::memcpy(&m, mask, sizeof(m));
+
+    vec a = s[0], b = s[1], c = s[2], d = s[3], e = s[4];
+
+    std::size_t i = 0;
+    for(; i < 16; ++i){
+        HADOKEN_SHA1_LANES_ROUND((b & c) | (~b & d), 0x5A827999);
+    }
+    for(; i < 20; ++i){
+        HADOKEN_SHA1_LANES_SCHEDULE();
+        HADOKEN_SHA1_LANES_ROUND((b & c) | (~b & d), 0x5A827999);
+    }
+    for(; i < 40; ++i){
+        HADOKEN_SHA1_LANES_SCHEDULE();
+        HADOKEN_SHA1_LANES_ROUND(b ^ c ^ d, 0x6ED9EBA1);
+    }
+    for(; i < 60; ++i){
+        HADOKEN_SHA1_LANES_SCHEDULE();
+        HADOKEN_SHA1_LANES_ROUND((b & c) | (b & d) | (c & d), 0x8F1BBCDC);
+    }
+    for(; i < 80; ++i){
+        HADOKEN_SHA1_LANES_SCHEDULE();
+        HADOKEN_SHA1_LANES_ROUND(b ^ c ^ d, 0xCA62C1D6);
+    }
+
+    s[0] = ((s[0] + a) & m) | (s[0] & ~m);
+    s[1] = ((s[1] + b) & m) | (s[1] & ~m);
+    s[2] = ((s[2] + c) & m) | (s[2] & ~m);
+    s[3] = ((s[3] + d) & m) | (s[3] & ~m);
+    s[4] = ((s[4] + e) & m) | (s[4] & ~m);
+
+    std::memcpy(state, s, sizeof(s));
+}
+
+#undef HADOKEN_SHA1_LANES_SCHEDULE
+#undef HADOKEN_SHA1_LANES_ROUND
+#undef HADOKEN_SHA1_VROTL
+
+
+inline void sha1_compress_lanes_default(std::uint32_t* state, const std::uint8_t* const* blocks, const std::uint32_t* mask){
+    sha1_compress_lanes_body<sha1_multi_lanes_default>(state, blocks, mask);
+}
+
+
+#ifdef HADOKEN_SHA1_AVX2_BACKEND
+
+__attribute__((target("avx2")))
+inline void sha1_compress_lanes_avx2(std::uint32_t* state, const std::uint8_t* const* blocks, const std::uint32_t* mask){
+    sha1_compress_lanes_body<sha1_multi_lanes_avx2>(state, blocks, mask);
+}
+
+inline bool sha1_cpu_has_avx2(){
+    static const bool has_avx2 = (__builtin_cpu_supports("avx2") != 0);
+    return has_avx2;
+}
+
+#endif // HADOKEN_SHA1_AVX2_BACKEND
+
+
+#else
+
+
+/// portable lane by lane fallback
+inline void sha1_compress_lanes_default(std::uint32_t* state, const std::uint8_t* const* blocks, const std::uint32_t* mask){
+    const std::size_t lanes = sha1_multi_lanes_default;
+
+    for(std::size_t l = 0; l < lanes; ++l){
+        if(mask[l] == 0){
+            continue;
+        }
+        std::uint32_t lane_state[5];
+        for(std::size_t k = 0; k < 5; ++k){
+            lane_state[k] = state[k * lanes + l];
+        }
+        sha1_compress_generic(lane_state, blocks[l], 1);
+        for(std::size_t k = 0; k < 5; ++k){
+            state[k * lanes + l] = lane_state[k];
+        }
+    }
+}
+
+
+#endif // HADOKEN_SHA1_VECTOR_EXTENSIONS
+
+
+} // impl
+
+} // hadoken
+
+#endif // _HADOKEN_SHA1_MULTI_LANES_HPP_
@@ -40,10 +40,13 @@
 #include <sstream>
 #include <algorithm>
 #include <iomanip>
+#include <iterator>
 
 
 #include <hadoken/utility/endian.hpp>
 
+#include "bits/sha1_compress.hpp"
+
 //
 // SHA1 cryptographic hash implementation
 // in the same model of boost::uid::sha1
@@ -75,6 +78,7 @@ namespace hadoken
             m_digest[4] = 0xC3D2E1F0;
             m_blockByteIndex = 0;
             m_byteCount = 0;
+            m_flags.reset();
         }
 
 
@@ -94,34 +98,66 @@ namespace hadoken
 
         template<typename Iterator>
         inline void process_block(const Iterator start, const Iterator end) {
-            const std::uint8_t* begin = static_cast<const std::uint8_t*>(&(*start));
-            const std::uint8_t* finish = static_cast<const std::uint8_t*>(&(*end));
-            while(begin != finish) {
-                process_byte(*begin);
-                begin++;
+            const std::size_t len = static_cast<std::size_t>(std::distance(start, end));
+            if(len == 0){
+                return;
             }
+            process_block(static_cast<const void*>(&(*start)), len);
         }
 
+        ///
+        /// process a contiguous buffer of len bytes
+        ///
+        /// complete 64 bytes blocks are compressed directly from the input buffer,
+        /// only the partial head and tail go through the internal block buffer
+        ///
         inline void process_block(const void* const data, size_t len) {
-            const std::uint8_t* block = static_cast<const std::uint8_t*>(data);
-            process_block(block, block + len);
-        }
-
+            const std::uint8_t* input = static_cast<const std::uint8_t*>(data);
+            m_byteCount += len;
+
+            if(m_blockByteIndex > 0){
+                const std::size_t n_fill = std::min(len, m_block.size() - m_blockByteIndex);
+                std::memcpy(&m_block[m_blockByteIndex], input, n_fill);
+                m_blockByteIndex += n_fill;
+                input += n_fill;
+                len -= n_fill;
+
+                if(m_blockByteIndex < m_block.size()){
+                    return;
+                }
+                impl::sha1_compress(&m_digest[0], &m_block[0], 1);
+                m_blockByteIndex = 0;
+            }
 
+            const std::size_t n_blocks = len / m_block.size();
+            if(n_blocks > 0){
+                impl::sha1_compress(&m_digest[0], input, n_blocks);
+                input += n_blocks * m_block.size();
+                len -= n_blocks * m_block.size();
+            }
 
+            if(len > 0){
+                std::memcpy(&m_block[0], input, len);
+                m_blockByteIndex = len;
+            }
+        }
 
 
+        inline std::string to_string(){
+            return to_string(get_digest());
+        }
 
 
-        inline std::string to_string(){
+        ///
+        /// hexadecimal representation of a digest, same format than to_string()
+        ///
+        inline static std::string to_string(const digest32_t & digest){
             std::ostringstream ss;
 
-            digest8_t hash =  get_digest_bytes();
-
             ss << std::hex << std::setfill('0');
 
-            for(digest8_t::iterator it = hash.begin(); it < hash.end(); ++it){
-                ss << std::setw(2) << static_cast<unsigned int>(*it);
+            for(digest32_t::const_iterator it = digest.begin(); it < digest.end(); ++it){
+                ss << std::setw(8) << static_cast<unsigned long>(*it);
             }
 
             return ss.str();
@@ -160,100 +196,36 @@ namespace hadoken
             completed = 0x00
         };
 
-        inline static std::uint32_t left_rotate(std::uint32_t value, size_t count) {
-            return (value << count) ^ (value >> (32-count));
-        }
-
-
         inline void process_byte(std::uint8_t b){
             this->m_block[this->m_blockByteIndex++] = b;
             ++this->m_byteCount;
             if(m_blockByteIndex == 64) {
                 this->m_blockByteIndex = 0;
-                process_internal();
+                impl::sha1_compress(&m_digest[0], &m_block[0], 1);
             }
         }
 
 
         inline void finalize(){
             if(m_flags[completed] == false){
-                size_t bitCount = this->m_byteCount * 8;
-
-                process_byte(0x80);
-                if (this->m_blockByteIndex > 56) {
-                    while (m_blockByteIndex != 0) {
-                        process_byte(0);
-                    }
-                    while (m_blockByteIndex < 56) {
-                        process_byte(0);
-                    }
-                } else {
-                    while (m_blockByteIndex < 56) {
-                        process_byte(0);
-                    }
-                }
-                process_byte(0);
-                process_byte(0);
-                process_byte(0);
-                process_byte(0);
-                process_byte( static_cast<unsigned char>((bitCount>>24) & 0xFF));
-                process_byte( static_cast<unsigned char>((bitCount>>16) & 0xFF));
-                process_byte( static_cast<unsigned char>((bitCount>>8 ) & 0xFF));
-                process_byte( static_cast<unsigned char>((bitCount)     & 0xFF));
+                const std::uint64_t bitCount = static_cast<std::uint64_t>(this->m_byteCount) * 8;
 
-                m_flags[completed] = true;
-            }
-        }
+                // 0x80, zero padding up to 56 mod 64, then the 64 bits big endian message length
+                std::array<std::uint8_t, 128> padding;
+                padding.fill(0);
+                padding[0] = 0x80;
 
+                const std::size_t n_pad = (m_blockByteIndex < 56) ? (56 - m_blockByteIndex) : (120 - m_blockByteIndex);
+                for(std::size_t i = 0; i < 8; ++i){
+                    padding[n_pad + i] = static_cast<std::uint8_t>((bitCount >> (56 - i * 8)) & 0xFF);
+                }
 
-        inline void process_internal() {
-            std::uint32_t w[80];
-            for (size_t i = 0; i < 16; i++) {
-                w[i]  = (m_block[i*4 + 0] << 24);
-                w[i] |= (m_block[i*4 + 1] << 16);
-                w[i] |= (m_block[i*4 + 2] << 8);
-                w[i] |= (m_block[i*4 + 3]);
-            }
-            for (size_t i = 16; i < 80; i++) {
-                w[i] = left_rotate((w[i-3] ^ w[i-8] ^ w[i-14] ^ w[i-16]), 1);
-            }
+                const size_t byteCount = m_byteCount;
+                process_block(&padding[0], n_pad + 8);
+                m_byteCount = byteCount;
 
-            std::uint32_t a = m_digest[0];
-            std::uint32_t b = m_digest[1];
-            std::uint32_t c = m_digest[2];
-            std::uint32_t d = m_digest[3];
-            std::uint32_t e = m_digest[4];
-
-            for (std::size_t i=0; i<80; ++i) {
-                std::uint32_t f = 0;
-                std::uint32_t k = 0;
-
-                if (i<20) {
-                    f = (b & c) | (~b & d);
-                    k = 0x5A827999;
-                } else if (i<40) {
-                    f = b ^ c ^ d;
-                    k = 0x6ED9EBA1;
-                } else if (i<60) {
-                    f = (b & c) | (b & d) | (c & d);
-                    k = 0x8F1BBCDC;
-                } else {
-                    f = b ^ c ^ d;
-                    k = 0xCA62C1D6;
-                }
-                std::uint32_t temp = left_rotate(a, 5) + f + e + k + w[i];
-                e = d;
-                d = c;
-                c = left_rotate(b, 30);
-                b = a;
-                a = temp;
+                m_flags[completed] = true;
             }
-
-            m_digest[0] += a;
-            m_digest[1] += b;
-            m_digest[2] += c;
-            m_digest[3] += d;
-            m_digest[4] += e;
         }
 
     };
@@ -0,0 +1,256 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ * 
+ * Boost Software License - Version 1.0 
+ * 
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ * 
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+* 
+*/
+#ifndef _HADOKEN_SHA1_MULTI_HPP_
+#define _HADOKEN_SHA1_MULTI_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "sha1.hpp"
+#include "bits/sha1_multi_lanes.hpp"
+
+
+namespace hadoken
+{
+
+
+namespace impl{
+
+typedef void (*sha1_compress_lanes_fn)(std::uint32_t*, const std::uint8_t* const*, const std::uint32_t*);
+
+
+struct sha1_multi_message{
+    const std::uint8_t* data;
+    std::size_t size;
+    std::size_t n_blocks;
+    std::size_t index;
+};
+
+
+/// hash up to Lanes messages together
+///
+/// complete blocks are read directly from the messages, the padding
+/// blocks are built in a per lane tail buffer
+template<std::size_t Lanes>
+inline void sha1_multi_group(const sha1_multi_message* messages, std::size_t n, sha1::digest32_t* digests, sha1_compress_lanes_fn compress){
+    static const std::uint8_t zero_block[64] = { 0 };
+    const std::uint32_t iv[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+
+    std::uint32_t state[5 * Lanes];
+    std::uint8_t tails[Lanes][128];
+    std::size_t n_full[Lanes];
+    std::size_t max_blocks = 0;
+
+    for(std::size_t l = 0; l < Lanes; ++l){
+        for(std::size_t k = 0; k < 5; ++k){
+            state[k * Lanes + l] = iv[k];
+        }
+        n_full[l] = 0;
+
+        if(l >= n){
+            continue;
+        }
+
+        const sha1_multi_message & msg = messages[l];
+        const std::size_t remain = msg.size % 64;
+        const std::uint64_t bit_count = static_cast<std::uint64_t>(msg.size) * 8;
+        const std::size_t tail_size = msg.n_blocks * 64 - (msg.size - remain);
+
+        n_full[l] = msg.size / 64;
+
+        if(remain > 0){
+            std::memcpy(tails[l], msg.data + n_full[l] * 64, remain);
+        }
+        tails[l][remain] = 0x80;
+        std::memset(tails[l] + remain + 1, 0, tail_size - 8 - remain - 1);
+        for(std::size_t i = 0; i < 8; ++i){
+            tails[l][tail_size - 8 + i] = static_cast<std::uint8_t>((bit_count >> (56 - i * 8)) & 0xFF);
+        }
+
+        max_blocks = std::max(max_blocks, msg.n_blocks);
+    }
+
+    const std::uint8_t* blocks[Lanes];
+    std::uint32_t mask[Lanes];
+
+    for(std::size_t b = 0; b < max_blocks; ++b){
+        for(std::size_t l = 0; l < Lanes; ++l){
+            if(l < n && b < messages[l].n_blocks){
+                blocks[l] = (b < n_full[l]) ? (messages[l].data + b * 64) : (tails[l] + (b - n_full[l]) * 64);
+                mask[l] = 0xFFFFFFFF;
+            }else{
+                blocks[l] = zero_block;
+                mask[l] = 0;
+            }
+        }
+        compress(state, blocks, mask);
+    }
+
+    for(std::size_t l = 0; l < n; ++l){
+        for(std::size_t k = 0; k < 5; ++k){
+            digests[messages[l].index][k] = state[k * Lanes + l];
+        }
+    }
+}
+
+
+} // impl
+
+
+///
+/// multi-buffer sha1 processing object
+///
+/// hash a batch of independent messages, 4 or 8 at once in the SIMD lanes
+/// of the CPU ( AVX2 is selected at runtime when available )
+///
+/// the messages are any contiguous range with data() and size(),
+/// e.g std::string, std::vector<std::uint8_t> or hadoken::string_view
+///
+///  \code
+///    hadoken::sha1_multi hasher;
+///    std::vector<hadoken::sha1::digest32_t> res = hasher.hash(messages);
+///    std::string hex = hadoken::sha1_multi::to_string(res[0]);
+///  \endcode
+///
+class sha1_multi
+{
+public:
+    typedef sha1::digest32_t digest32_t;
+
+    enum backend_type{
+        backend_auto,   ///< fastest backend of the CPU
+        backend_lanes   ///< always use the SIMD lanes
+    };
+
+    inline explicit sha1_multi(backend_type backend = backend_auto) : m_lanes(impl::sha1_multi_lanes_default), m_compress(&impl::sha1_compress_lanes_default){
+#ifdef HADOKEN_SHA1_AVX2_BACKEND
+        if(impl::sha1_cpu_has_avx2()){
+            m_lanes = impl::sha1_multi_lanes_avx2;
+            m_compress = &impl::sha1_compress_lanes_avx2;
+        }
+#endif
+#ifdef HADOKEN_SHA1_SHANI_BACKEND
+        // the SHA extensions on one message beat the SIMD lanes
+        if(backend == backend_auto && impl::sha1_cpu_has_shani()){
+            m_lanes = 1;
+            m_compress = nullptr;
+        }
+#endif
+        (void) backend;
+    }
+
+    /// number of messages hashed concurrently,
+    /// 1 when the messages are hashed one by one with the SHA extensions
+    inline std::size_t lanes() const{
+        return m_lanes;
+    }
+
+    /// hash each message of the range [first, last)
+    template<typename Iterator>
+    inline std::vector<digest32_t> hash(Iterator first, Iterator last) const{
+        if(m_compress == nullptr){
+            return hash_serial(first, last);
+        }
+
+        std::vector<impl::sha1_multi_message> messages;
+        messages.reserve(static_cast<std::size_t>(std::distance(first, last)));
+
+        for(std::size_t index = 0; first != last; ++first, ++index){
+            typedef typename std::iterator_traits<Iterator>::value_type span_type;
+            const span_type & span = *first;
+
+            impl::sha1_multi_message msg;
+            msg.data = static_cast<const std::uint8_t*>(static_cast<const void*>(span.data()));
+            msg.size = span.size() * sizeof(*span.data());
+            msg.n_blocks = (msg.size + 8) / 64 + 1;
+            msg.index = index;
+            messages.push_back(msg);
+        }
+
+        // group messages of similar size together, to minimize the number of idle lanes
+        const auto longer = [](const impl::sha1_multi_message & m1, const impl::sha1_multi_message & m2){
+            return m1.n_blocks > m2.n_blocks;
+        };
+        if(std::is_sorted(messages.begin(), messages.end(), longer) == false){
+            std::stable_sort(messages.begin(), messages.end(), longer);
+        }
+
+        std::vector<digest32_t> digests(messages.size());
+
+        for(std::size_t i = 0; i < messages.size(); i += m_lanes){
+            const std::size_t n = std::min<std::size_t>(m_lanes, messages.size() - i);
+            if(m_lanes == impl::sha1_multi_lanes_avx2){
+                impl::sha1_multi_group<impl::sha1_multi_lanes_avx2>(&messages[i], n, &digests[0], m_compress);
+            }else{
+                impl::sha1_multi_group<impl::sha1_multi_lanes_default>(&messages[i], n, &digests[0], m_compress);
+            }
+        }
+
+        return digests;
+    }
+
+    /// hash each message of the container
+    template<typename Container>
+    inline std::vector<digest32_t> hash(const Container & messages) const{
+        return hash(std::begin(messages), std::end(messages));
+    }
+
+    /// hexadecimal representation of a digest, same format than sha1::to_string()
+    inline static std::string to_string(const digest32_t & digest){
+        return sha1::to_string(digest);
+    }
+
+private:
+    std::size_t m_lanes;
+    impl::sha1_compress_lanes_fn m_compress;
+
+    template<typename Iterator>
+    inline std::vector<digest32_t> hash_serial(Iterator first, Iterator last) const{
+        std::vector<digest32_t> digests;
+        digests.reserve(static_cast<std::size_t>(std::distance(first, last)));
+
+        for(; first != last; ++first){
+            sha1 sha_compute;
+            sha_compute.process_block(static_cast<const void*>(first->data()), first->size() * sizeof(*first->data()));
+            digests.push_back(sha_compute.get_digest());
+        }
+        return digests;
+    }
+};
+
+
+}
+
+
+#endif // _HADOKEN_SHA1_MULTI_HPP_
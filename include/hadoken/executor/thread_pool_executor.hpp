@@ -32,12 +32,20 @@
 #include <atomic>
 #include <thread>
 #include <chrono>
+#include <cstdint>
+#include <deque>
 #include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
 #include <vector>
 #include <type_traits>
 
+#include <pthread.h>
 
 #include <hadoken/thread/future_helpers.hpp>
+#include <hadoken/thread/spinlock.hpp>
 #include <hadoken/threading/std_thread_model.hpp>
 #include <hadoken/containers/concurrent_queue.hpp>
 
@@ -45,15 +53,27 @@
 namespace hadoken{
 
 
+///
+/// task scheduling strategy of the thread_pool_executor
+///
+enum class thread_pool_scheduler{
+    /// all workers pop from a single shared FIFO queue
+    shared_queue,
+    /// each worker owns a task deque, pops locally in LIFO order
+    /// and steals in FIFO order from a random victim when idle
+    work_stealing
+};
+
+
 namespace details{
 
 class worker_thread{
 public:
-    inline worker_thread(concurrent_queue<std::function<void ()>> & queue) :
-                    _queue_ref(queue),
+    template<typename Loop>
+    inline worker_thread(Loop loop) :
                     exec(),
                     finished(false) {
-        std::thread runner([this]() { run();});
+        std::thread runner([this, loop]() { loop(finished);});
 
         exec.swap(runner);
     }
@@ -66,32 +86,86 @@ public:
         }
     }
 
+private:
+    worker_thread(const worker_thread &) = delete;
 
-    inline void run(){
-        while(!finished){
-            auto work_item = _queue_ref.try_pop(std::chrono::milliseconds(10));
-            if(work_item){
-                work_item.get()();
-            }
+    std::thread exec;
 
+    std::atomic<bool> finished;
+};
+
+
+///
+/// task deque owned by a single worker
+///  LIFO access for the owner, FIFO access for the thieves
+///
+class work_stealing_deque{
+public:
+    inline work_stealing_deque() : _lock(), _tasks() {}
+
+    inline void push(std::function<void ()> task){
+        std::lock_guard<hadoken::thread::spin_lock> l(_lock);
+        _tasks.push_back(std::move(task));
+    }
+
+    inline bool pop(std::function<void ()> & task){
+        std::lock_guard<hadoken::thread::spin_lock> l(_lock);
+        if(_tasks.empty()){
+            return false;
         }
+        task = std::move(_tasks.back());
+        _tasks.pop_back();
+        return true;
+    }
+
+    inline bool steal(std::function<void ()> & task){
+        std::lock_guard<hadoken::thread::spin_lock> l(_lock);
+        if(_tasks.empty()){
+            return false;
+        }
+        task = std::move(_tasks.front());
+        _tasks.pop_front();
+        return true;
     }
 
 private:
-    worker_thread(const worker_thread &) = delete;
+    work_stealing_deque(const work_stealing_deque &) = delete;
 
-    concurrent_queue<std::function<void ()>> & _queue_ref;
+    hadoken::thread::spin_lock _lock;
+    std::deque<std::function<void ()> > _tasks;
+};
 
-    std::thread exec;
 
-    std::atomic<bool> finished;
+///
+/// task submitted from a pool thread in work stealing mode
+/// can be run either by a worker or by the thread waiting for its result,
+/// whichever claims it first
+///
+template<typename Result>
+struct claimable_task{
+    template<typename Function>
+    inline claimable_task(Function func) : claimed(false), function(std::move(func)), prom(), result(prom.get_future()) {}
+
+    inline bool try_claim(){
+        return (claimed.exchange(true) == false);
+    }
+
+    std::atomic<bool> claimed;
+    std::function<Result ()> function;
+    std::promise<Result> prom;
+    std::future<Result> result;
 };
 
 
 }
 
 ///
-/// \brief Executor implementation for a simple thread
+/// \brief Executor implementation for a pool of threads
+///
+///  By default, tasks go through a single shared queue.
+///  In work stealing mode, each worker owns a task deque: tasks submitted
+///  from a worker go to its own deque, tasks submitted from outside the pool
+///  are distributed in round robin.
 ///
 class thread_pool_executor : public std_thread_model{
 public:
@@ -102,49 +176,79 @@ public:
     template<typename T>
     using promise = std::promise<T>;
 
-    inline thread_pool_executor(std::size_t n_thread =0) :
+    inline thread_pool_executor(std::size_t n_thread =0,
+                                thread_pool_scheduler scheduler = thread_pool_scheduler::shared_queue) :
+        _scheduler(scheduler),
         _work_queue(),
+        _deques(),
+        _next_deque(0),
+        _n_idle(0),
+        _idle_lock(),
+        _idle_cond(),
         _executors(){
         pthread_key_create(&_recursive_key, NULL);
 
         const std::size_t n_workers = (n_thread > 0) ? n_thread : (std::thread::hardware_concurrency());
+
+        if(_scheduler == thread_pool_scheduler::work_stealing){
+            for(std::size_t i =0; i < n_workers; ++i){
+                _deques.emplace_back(new details::work_stealing_deque());
+            }
+        }
+
         for(std::size_t i =0; i < n_workers; ++i){
-            _executors.emplace_back( new details::worker_thread(_work_queue));
+            _executors.emplace_back( new details::worker_thread([this, i](const std::atomic<bool> & finished){
+                run(i, finished);
+            }));
         }
     }
 
     inline ~thread_pool_executor(){
+        _executors.clear();
         pthread_key_delete(_recursive_key);
     }
 
+    inline thread_pool_scheduler scheduler() const{
+        return _scheduler;
+    }
+
     inline void execute(std::function<void (void)> task){
-        _work_queue.push(std::move(task));
+        submit(std::move(task));
     }
 
     template<typename Function>
     inline future<decltype(std::declval<Function>()())> twoway_execute(Function func){
+        using result_type = decltype(std::declval<Function>()());
 
         // if our current thread is not part of the pool
         // we execute in the pool
         // if it is already a pooled_thread, we do not to avoid deadlock
         if(pthread_getspecific(_recursive_key) == NULL){
 
-            auto prom = std::make_shared<promise<decltype(std::declval<Function>()()) > >();
+            auto prom = std::make_shared<promise<result_type> >();
             auto future_result = prom->get_future();
 
-            _work_queue.push([prom, func, this]() mutable -> void{
-                pthread_setspecific(this->_recursive_key, (void*)1);
-                try{
-                    set_promise_from_result(*prom, func);
-                } catch(...) {
-                    try {
-                        prom->set_exception(std::current_exception());
-                    } catch(...) {
-                        std::cerr << "error during set_exception in executor" << std::endl;
-                    }
-                }
+            submit([prom, func]() mutable -> void{
+                set_promise_from_result_or_exception(*prom, func);
             });
             return future_result;
+        } else if(_scheduler == thread_pool_scheduler::work_stealing){
+            // the task is pushed on the local deque where it can be stolen,
+            // if nobody took it when the result is requested, the caller runs it
+            auto task = std::make_shared<details::claimable_task<result_type> >(std::move(func));
+
+            submit([task]() -> void{
+                if(task->try_claim()){
+                    set_promise_from_result_or_exception(task->prom, task->function);
+                }
+            });
+
+            return std::async(std::launch::deferred, [task]() -> result_type {
+                if(task->try_claim()){
+                    return task->function();
+                }
+                return task->result.get();
+            });
         } else{
             return std::async(std::launch::deferred, [func]() {
                 return func();
@@ -153,7 +257,106 @@ public:
     }
 
 private:
+    static constexpr std::size_t no_worker = std::size_t(-1);
+
+    template<typename Result, typename Function>
+    static inline void set_promise_from_result_or_exception(promise<Result> & prom, Function & func){
+        try{
+            set_promise_from_result(prom, func);
+        } catch(...) {
+            try {
+                prom.set_exception(std::current_exception());
+            } catch(...) {
+                std::cerr << "error during set_exception in executor" << std::endl;
+            }
+        }
+    }
+
+    // index of the current worker thread, no_worker if not part of this pool
+    inline std::size_t current_worker() const{
+        return reinterpret_cast<std::uintptr_t>(pthread_getspecific(_recursive_key)) - 1;
+    }
+
+    inline void submit(std::function<void (void)> task){
+        if(_scheduler == thread_pool_scheduler::shared_queue){
+            _work_queue.push(std::move(task));
+            return;
+        }
+
+        std::size_t target = current_worker();
+        if(target == no_worker){
+            target = _next_deque.fetch_add(1, std::memory_order_relaxed) % _deques.size();
+        }
+        _deques[target]->push(std::move(task));
+
+        if(_n_idle.load() > 0){
+            std::lock_guard<std::mutex> l(_idle_lock);
+            _idle_cond.notify_one();
+        }
+    }
+
+    inline bool try_steal(std::size_t id, std::minstd_rand & rand_gen, std::function<void ()> & task){
+        const std::size_t n_deques = _deques.size();
+        const std::size_t first_victim = rand_gen() % n_deques;
+
+        for(std::size_t i = 0; i < n_deques; ++i){
+            const std::size_t victim = (first_victim + i) % n_deques;
+            if(victim != id && _deques[victim]->steal(task)){
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline void run(std::size_t id, const std::atomic<bool> & finished){
+        pthread_setspecific(_recursive_key, reinterpret_cast<void*>(id + 1));
+
+        if(_scheduler == thread_pool_scheduler::shared_queue){
+            while(!finished){
+                auto work_item = _work_queue.try_pop(std::chrono::milliseconds(10));
+                if(work_item){
+                    work_item.get()();
+                }
+            }
+            return;
+        }
+
+        std::minstd_rand rand_gen(static_cast<std::minstd_rand::result_type>(id + 1));
+        std::function<void ()> task;
+
+        while(!finished){
+            if(_deques[id]->pop(task) || try_steal(id, rand_gen, task)){
+                task();
+                task = nullptr;
+                continue;
+            }
+
+            // nothing to do, sleep until a submission
+            std::unique_lock<std::mutex> l(_idle_lock);
+            _n_idle.fetch_add(1);
+            if(try_steal(no_worker, rand_gen, task)){
+                _n_idle.fetch_sub(1);
+                l.unlock();
+                task();
+                task = nullptr;
+                continue;
+            }
+            _idle_cond.wait_for(l, std::chrono::milliseconds(10));
+            _n_idle.fetch_sub(1);
+        }
+    }
+
+    thread_pool_scheduler _scheduler;
+
     concurrent_queue<std::function<void ()>> _work_queue;
+
+    std::vector<std::unique_ptr<details::work_stealing_deque> > _deques;
+    std::atomic<std::size_t> _next_deque;
+
+    std::atomic<std::size_t> _n_idle;
+    std::mutex _idle_lock;
+    std::condition_variable _idle_cond;
+
     std::vector<std::unique_ptr<details::worker_thread> > _executors;
 
     pthread_key_t _recursive_key;
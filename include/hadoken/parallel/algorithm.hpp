@@ -30,6 +30,10 @@
 #define _HADOKEN_PARALLEL_ALGORITHM_HPP_
 
 #include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
 
 
 namespace hadoken{
@@ -38,14 +42,132 @@ namespace hadoken{
 namespace parallel{
 
 
+///
+/// distribution of the elements over the tasks of a parallel algorithm
+///
+enum class schedule_type{
+    /// one contiguous slice of equal size per task
+    static_split,
+    /// tasks take chunks of a fixed size from a shared cursor
+    /// until the range is exhausted
+    dynamic,
+    /// like dynamic, with chunks proportional to the remaining elements
+    guided
+};
+
+
+namespace detail{
+
+///
+/// type erased reference to an executor, used by the parallel algorithms
+/// to submit their tasks. The executor must outlive the algorithm call.
+///
+class executor_ref{
+public:
+    constexpr executor_ref() : _executor(nullptr), _execute(nullptr){}
+
+    template<typename Executor>
+    inline explicit executor_ref(Executor & executor) : _executor(&executor), _execute(&execute_thunk<Executor>){}
+
+    inline bool valid() const{
+        return _executor != nullptr;
+    }
+
+    inline void execute(std::function<void ()> task) const{
+        _execute(_executor, std::move(task));
+    }
+
+private:
+    template<typename Executor>
+    static void execute_thunk(void* executor, std::function<void ()> task){
+        static_cast<Executor*>(executor)->execute(std::move(task));
+    }
+
+    void* _executor;
+    void (*_execute)(void*, std::function<void ()>);
+};
+
+
+///
+/// configuration carried by the parallel execution policies
+///
+struct execution_config{
+    constexpr execution_config() : executor(), n_threads(0), grain(1), schedule(schedule_type::static_split){}
+
+    /// executor running the tasks, the system executor if not valid
+    executor_ref executor;
+    /// maximum number of concurrent tasks, hardware concurrency if 0
+    std::size_t n_threads;
+    /// minimum number of elements per task
+    std::size_t grain;
+    /// scheduling of the elements over the tasks
+    schedule_type schedule;
+};
+
+
+///
+/// base of the configurable execution policies
+///
+///  \code
+///    thread_pool_executor pool(8);
+///    parallel::for_each(parallel::par.on(pool).with_grain(4096), v.begin(), v.end(), fun);
+///  \endcode
+///
+template<typename Policy>
+class configurable_policy{
+public:
+    constexpr configurable_policy() : _config(){}
+
+    /// run the tasks of the algorithm on executor ( e.g a thread_pool_executor )
+    template<typename Executor>
+    inline Policy on(Executor & executor) const{
+        Policy res(static_cast<const Policy &>(*this));
+        res._config.executor = executor_ref(executor);
+        return res;
+    }
+
+    /// use at most n_threads concurrent tasks ( 0: hardware concurrency )
+    inline Policy with_threads(std::size_t n_threads) const{
+        Policy res(static_cast<const Policy &>(*this));
+        res._config.n_threads = n_threads;
+        return res;
+    }
+
+    /// never create a task for less than grain elements
+    inline Policy with_grain(std::size_t grain) const{
+        Policy res(static_cast<const Policy &>(*this));
+        res._config.grain = (grain > 0) ? grain : 1;
+        return res;
+    }
+
+    /// distribute the elements with schedule, dynamic and guided
+    /// balance irregular workloads ( for_range based algorithms only ).
+    /// Non random access ranges are always walked in chunks, once.
+    inline Policy with_schedule(schedule_type schedule) const{
+        Policy res(static_cast<const Policy &>(*this));
+        res._config.schedule = schedule;
+        return res;
+    }
+
+    inline const execution_config & config() const{
+        return _config;
+    }
+
+private:
+    execution_config _config;
+};
+
+} // detail
+
+
 /// sequential execution, no parallelism
 class sequential_execution_policy{};
 
 /// parallel execution allowed
-class parallel_execution_policy{};
+class parallel_execution_policy : public detail::configurable_policy<parallel_execution_policy>{};
 
 /// parallel execution allowed, vector execution allowed
-class parallel_vector_execution_policy{};
+class parallel_vector_execution_policy : public detail::configurable_policy<parallel_vector_execution_policy>{};
 
 
 /// constexpr for sequential execution
@@ -106,6 +228,73 @@ template< class ExecutionPolicy, class InputIterator, class UnaryPredicate >
 inline bool none_of( ExecutionPolicy&& policy, InputIterator first, InputIterator last, UnaryPredicate p );
 
 
+/// parallel find algorithm, first element equal to value
+template< class ExecutionPolicy, class InputIterator, class T >
+inline InputIterator find( ExecutionPolicy&& policy, InputIterator first, InputIterator last, const T & value );
+
+/// parallel find_if algorithm, first element satisfying p
+template< class ExecutionPolicy, class InputIterator, class UnaryPredicate >
+inline InputIterator find_if( ExecutionPolicy&& policy, InputIterator first, InputIterator last, UnaryPredicate p );
+
+/// parallel find_if_not algorithm, first element not satisfying p
+template< class ExecutionPolicy, class InputIterator, class UnaryPredicate >
+inline InputIterator find_if_not( ExecutionPolicy&& policy, InputIterator first, InputIterator last, UnaryPredicate p );
+
+
+
+
+/// parallel min_element algorithm, first smallest element
+template< class ExecutionPolicy, class ForwardIt >
+inline ForwardIt min_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last );
+
+/// parallel min_element algorithm with comparator
+template< class ExecutionPolicy, class ForwardIt, class Compare >
+inline ForwardIt min_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, Compare comp );
+
+/// parallel max_element algorithm, first largest element
+template< class ExecutionPolicy, class ForwardIt >
+inline ForwardIt max_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last );
+
+/// parallel max_element algorithm with comparator
+template< class ExecutionPolicy, class ForwardIt, class Compare >
+inline ForwardIt max_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, Compare comp );
+
+/// parallel minmax_element algorithm, first smallest and last largest elements
+template< class ExecutionPolicy, class ForwardIt >
+inline std::pair<ForwardIt, ForwardIt> minmax_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last );
+
+/// parallel minmax_element algorithm with comparator
+template< class ExecutionPolicy, class ForwardIt, class Compare >
+inline std::pair<ForwardIt, ForwardIt> minmax_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, Compare comp );
+
+
+
+
+/// parallel copy_if algorithm, stable copy of the elements satisfying p
+template< class ExecutionPolicy, class InputIt, class OutputIt, class UnaryPredicate >
+inline OutputIt copy_if( ExecutionPolicy&& policy, InputIt first, InputIt last, OutputIt d_first, UnaryPredicate p );
+
+/// parallel remove_if algorithm, stable removal of the elements satisfying p
+template< class ExecutionPolicy, class ForwardIt, class UnaryPredicate >
+inline ForwardIt remove_if( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryPredicate p );
+
+/// parallel partition algorithm, the elements satisfying p first
+template< class ExecutionPolicy, class ForwardIt, class UnaryPredicate >
+inline ForwardIt partition( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryPredicate p );
+
+/// parallel stable_partition algorithm, the elements satisfying p first, relative order preserved
+template< class ExecutionPolicy, class BidirIt, class UnaryPredicate >
+inline BidirIt stable_partition( ExecutionPolicy&& policy, BidirIt first, BidirIt last, UnaryPredicate p );
+
+/// parallel unique algorithm, removes the consecutive duplicates
+template< class ExecutionPolicy, class ForwardIt >
+inline ForwardIt unique( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last );
+
+/// parallel unique algorithm with equivalence predicate
+template< class ExecutionPolicy, class ForwardIt, class BinaryPredicate >
+inline ForwardIt unique( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, BinaryPredicate p );
+
+
 
 
 /// sort algorithm
@@ -116,6 +305,20 @@ void sort( ExecutionPolicy&& policy, RandomIt first, RandomIt last );
 template< class ExecutionPolicy, class RandomIt, class Compare >
 void sort( ExecutionPolicy&& policy, RandomIt first, RandomIt last, Compare comp );
 
+/// Extension: radix_sort algorithm
+///
+/// stable LSD radix sort of integral or floating point keys, in ascending order.
+/// For floating points, -0.0 is ordered before +0.0 and the NaN at the extremities
+template< class ExecutionPolicy, class RandomIt >
+void radix_sort( ExecutionPolicy&& policy, RandomIt first, RandomIt last );
+
+/// Extension: sort_by_key algorithm
+///
+/// radix sort of the keys [keys_first, keys_last), the values starting at values_first
+/// are moved along with their key. Stable, values must be default constructible
+template< class ExecutionPolicy, class RandomIt1, class RandomIt2 >
+void sort_by_key( ExecutionPolicy&& policy, RandomIt1 keys_first, RandomIt1 keys_last, RandomIt2 values_first );
+
 
 
 ///
@@ -131,8 +334,91 @@ class BinaryOperation>
 OutputIt inclusive_scan( ExecutionPolicy&& policy,
                          InputIt first, InputIt last, OutputIt d_first,
                          BinaryOperation binary_op);
-                         
-                         
+
+/// inclusive scan algorithm binary op and initial value
+template< class ExecutionPolicy, class InputIt, class OutputIt,
+class BinaryOperation, class T >
+OutputIt inclusive_scan( ExecutionPolicy&& policy,
+                         InputIt first, InputIt last, OutputIt d_first,
+                         BinaryOperation binary_op, T init);
+
+/// exclusive scan algorithm
+template< class ExecutionPolicy, class InputIt, class OutputIt, class T >
+OutputIt exclusive_scan( ExecutionPolicy&& policy,
+                         InputIt first, InputIt last, OutputIt d_first,
+                         T init);
+
+/// exclusive scan algorithm binary op
+template< class ExecutionPolicy, class InputIt, class OutputIt, class T, class BinaryOperation >
+OutputIt exclusive_scan( ExecutionPolicy&& policy,
+                         InputIt first, InputIt last, OutputIt d_first,
+                         T init, BinaryOperation binary_op);
+
+/// transform inclusive scan algorithm
+template< class ExecutionPolicy, class InputIt, class OutputIt,
+class BinaryOperation, class UnaryOperation >
+OutputIt transform_inclusive_scan( ExecutionPolicy&& policy,
+                                   InputIt first, InputIt last, OutputIt d_first,
+                                   BinaryOperation binary_op, UnaryOperation unary_op);
+
+/// transform inclusive scan algorithm with initial value
+template< class ExecutionPolicy, class InputIt, class OutputIt,
+class BinaryOperation, class UnaryOperation, class T >
+OutputIt transform_inclusive_scan( ExecutionPolicy&& policy,
+                                   InputIt first, InputIt last, OutputIt d_first,
+                                   BinaryOperation binary_op, UnaryOperation unary_op, T init);
+
+
+/// reduce algorithm
+template< class ExecutionPolicy, class InputIt >
+typename std::iterator_traits<InputIt>::value_type
+    reduce( ExecutionPolicy&& policy, InputIt first, InputIt last );
+
+/// reduce algorithm with initial value
+template< class ExecutionPolicy, class InputIt, class T >
+T reduce( ExecutionPolicy&& policy, InputIt first, InputIt last, T init );
+
+/// reduce algorithm binary op
+template< class ExecutionPolicy, class InputIt, class T, class BinaryOperation >
+T reduce( ExecutionPolicy&& policy, InputIt first, InputIt last, T init, BinaryOperation binary_op );
+
+/// transform_reduce algorithm, inner product of two ranges
+template< class ExecutionPolicy, class InputIt1, class InputIt2, class T >
+T transform_reduce( ExecutionPolicy&& policy, InputIt1 first1, InputIt1 last1, InputIt2 first2, T init );
+
+/// transform_reduce algorithm on two ranges
+template< class ExecutionPolicy, class InputIt1, class InputIt2, class T, class BinaryReduceOp, class BinaryTransformOp >
+T transform_reduce( ExecutionPolicy&& policy, InputIt1 first1, InputIt1 last1, InputIt2 first2, T init,
+                    BinaryReduceOp reduce_op, BinaryTransformOp transform_op );
+
+/// transform_reduce algorithm on one range
+template< class ExecutionPolicy, class InputIt, class T, class BinaryReduceOp, class UnaryTransformOp >
+T transform_reduce( ExecutionPolicy&& policy, InputIt first, InputIt last, T init,
+                    BinaryReduceOp reduce_op, UnaryTransformOp transform_op );
+
+
+/// count_if algorithm
+template< class ExecutionPolicy, class InputIterator, class UnaryPredicate >
+typename std::iterator_traits<InputIterator>::difference_type
+    count_if( ExecutionPolicy&& policy, InputIterator first, InputIterator last, UnaryPredicate p );
+
+/// count algorithm
+template< class ExecutionPolicy, class InputIterator, class T >
+typename std::iterator_traits<InputIterator>::difference_type
+    count( ExecutionPolicy&& policy, InputIterator first, InputIterator last, const T &value );
+
+
+
+/// Extension: generate_random algorithm
+///
+/// fill a range with the output stream of a counter based random engine ( e.g counter_engine )
+/// each subrange seeks a copy of the engine to its own offset: the result is identical
+/// to a sequential generation, whatever the number of executors.
+/// engine is advanced by std::distance(first, last)
+template< class ExecutionPolicy, class RandomIt, class Engine >
+void generate_random( ExecutionPolicy&& policy, RandomIt first, RandomIt last, Engine & engine );
+
+
 
 /// Extension: for_range_ algorithm
 ///
@@ -33,6 +33,12 @@
 #include <iterator>
 #include <stdexcept>
 #include <cstdint>
+#include <exception>
+#include <memory>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 
 #include <hadoken/parallel/algorithm.hpp>
@@ -42,10 +48,18 @@
 #include <hadoken/containers/small_vector.hpp>
 
 #include <hadoken/parallel/bits/parallel_algorithm_generics.hpp>
+#include <hadoken/parallel/bits/parallel_segmented_generic.hpp>
+#include <hadoken/parallel/bits/parallel_find_generic.hpp>
 #include <hadoken/parallel/bits/parallel_none_any_all_generic.hpp>
+#include <hadoken/parallel/bits/parallel_minmax_generic.hpp>
 #include <hadoken/parallel/bits/parallel_transform_generic.hpp>
+#include <hadoken/parallel/bits/parallel_compaction_generic.hpp>
 #include <hadoken/parallel/bits/parallel_sort_generic.hpp>
+#include <hadoken/parallel/bits/parallel_radix_sort_generic.hpp>
 #include <hadoken/parallel/bits/parallel_numeric_generic.hpp>
+#include <hadoken/parallel/bits/parallel_reduce_generic.hpp>
+#include <hadoken/parallel/bits/parallel_count_generics.hpp>
+#include <hadoken/parallel/bits/parallel_random_generic.hpp>
 
 
 namespace hadoken{
@@ -64,32 +78,107 @@ namespace detail{
 
 inline int __get_number_executor(){
 #ifndef __HADOKEN_ALGORITHM_ENFORCE_SERIAL
-    // TODO : should be configurable parameter, extracted from execution_policy
-    return std::thread::hardware_concurrency();
+    return std::max<int>(static_cast<int>(std::thread::hardware_concurrency()), 1);
 #else
     return 1;
 #endif
 }
 
-template<typename Function>
-inline void __execute_grid(int num_executor, Function fun){
+inline int __get_number_executor(const execution_config & config){
 #ifndef __HADOKEN_ALGORITHM_ENFORCE_SERIAL
+    if(config.n_threads > 0){
+        return static_cast<int>(config.n_threads);
+    }
+#endif
+    return __get_number_executor();
+}
 
-    system_executor sys_exec;
-    std::vector<std::future<void>> futures;
+// number of slices for n_elems elements: one per executor at most,
+// never less than grain elements per slice
+inline std::size_t __get_number_slices(const execution_config & config, std::size_t n_elems){
+    const std::size_t n_exec = static_cast<std::size_t>(__get_number_executor(config));
+    const std::size_t n_grain = n_elems / config.grain;
+    return std::max<std::size_t>(std::min(n_exec, n_grain), 1);
+}
 
+// state of a fork-join grid, shared by the caller and the submitted tasks
+//
+// slices are claimed through an atomic counter by whoever runs first:
+// the caller works on the grid too and only waits for the slices already
+// claimed by other threads. A task that starts after all slices were claimed
+// returns immediately, this keeps the grid deadlock free when called from
+// a thread of the executor itself
+template<typename Function>
+struct fork_join_grid{
+    inline fork_join_grid(int num_slices, Function & function) :
+        next_slice(0),
+        n_slices(num_slices),
+        completion(num_slices),
+        fun(&function),
+        has_error(false),
+        error(){}
+
+    inline void run_slices(){
+        int id;
+        while( (id = next_slice.fetch_add(1, std::memory_order_relaxed)) < n_slices){
+            try{
+                (*fun)(id, n_slices);
+            } catch(...){
+                if(has_error.exchange(true) == false){
+                    error = std::current_exception();
+                }
+            }
+            completion.count_down();
+        }
+    }
 
+    std::atomic<int> next_slice;
+    const int n_slices;
+    thread::latch completion;
+    Function* fun;
+    std::atomic<bool> has_error;
+    std::exception_ptr error;
+};
+
+
+// run fun(id, num_executor) for id in [0, num_executor), the slices are
+// submitted with submit(task) and the caller participates
+template<typename Submit, typename Function>
+inline void _fork_join(Submit & submit, int num_executor, Function & fun){
+    if(num_executor <= 1){
+        if(num_executor == 1){
+            fun(0, 1);
+        }
+        return;
+    }
+
+    // the grid can outlive the call in the tasks not started yet
+    auto grid = std::make_shared<fork_join_grid<Function> >(num_executor, fun);
 
-    for(int id = 0; id < num_executor; ++id){
-        futures.emplace_back( std::move(sys_exec.twoway_execute([id, num_executor, &fun]{
-                return fun(id, num_executor);
-        })));
+    for(int i = 1; i < num_executor; ++i){
+        submit([grid]{
+            grid->run_slices();
+        });
     }
 
-    for(auto & f : futures){
-        f.get();
+    grid->run_slices();
+    grid->completion.wait();
+
+    if(grid->has_error.load()){
+        std::rethrow_exception(grid->error);
     }
+}
 
+
+template<typename Function>
+inline void __execute_grid(int num_executor, Function fun){
+#ifndef __HADOKEN_ALGORITHM_ENFORCE_SERIAL
+    system_executor sys_exec;
+    auto submit = [&sys_exec](std::function<void ()> task){
+        sys_exec.execute(std::move(task));
+    };
+
+    _fork_join(submit, num_executor, fun);
 #else
     for(int id =0 ; id < num_executor; ++id){
         fun(id, num_executor);
@@ -97,84 +186,137 @@ inline void __execute_grid(int num_executor, Function fun){
 #endif
 }
 
-/// for_each algorithm
+template<typename Function>
+inline void __execute_grid(const execution_config & config, int num_executor, Function fun){
+#ifndef __HADOKEN_ALGORITHM_ENFORCE_SERIAL
+    if(config.executor.valid()){
+        auto submit = [&config](std::function<void ()> task){
+            config.executor.execute(std::move(task));
+        };
+
+        _fork_join(submit, num_executor, fun);
+        return;
+    }
+#endif
+    __execute_grid(num_executor, std::move(fun));
+}
+
+// number of chunks per executor of the dynamic schedule, when not bounded by the grain
+constexpr std::size_t dynamic_schedule_chunks_per_executor = 16;
+
+
+// take the next chunk [chunk_begin, chunk_end) of the n_elems elements from the cursor
+// return false when the range is exhausted
+inline bool _next_schedule_chunk(const execution_config & config, std::atomic<std::size_t> & cursor,
+                                 std::size_t n_elems, std::size_t n_exec, std::size_t dynamic_chunk,
+                                 std::size_t & chunk_begin, std::size_t & chunk_end){
+    if(config.schedule == schedule_type::guided){
+        chunk_begin = cursor.load(std::memory_order_relaxed);
+        do{
+            if(chunk_begin >= n_elems){
+                return false;
+            }
+            const std::size_t remaining = n_elems - chunk_begin;
+            chunk_end = chunk_begin + std::min(remaining, std::max(config.grain, remaining / (2 * n_exec)));
+        } while(cursor.compare_exchange_weak(chunk_begin, chunk_end, std::memory_order_relaxed) == false);
+        return true;
+    }
+
+    chunk_begin = cursor.fetch_add(dynamic_chunk, std::memory_order_relaxed);
+    if(chunk_begin >= n_elems){
+        return false;
+    }
+    chunk_end = std::min(n_elems, chunk_begin + dynamic_chunk);
+    return true;
+}
+
+
+// dynamic and guided schedules: every executor takes chunks
+// from a shared atomic cursor until the range is exhausted
 template<typename Iterator, typename Function>
-inline void _omp_parallel_for_range(Iterator begin_it, Iterator end_it, Function fun){
-    range<Iterator> global_range(begin_it, end_it);
+inline void _parallel_for_range_chunks(const execution_config & config, int num_exec,
+                                       Iterator begin_it, std::size_t n_elems, Function & fun){
+    const std::size_t n_exec = static_cast<std::size_t>(num_exec);
+    const std::size_t dynamic_chunk = std::max(config.grain, n_elems / (n_exec * dynamic_schedule_chunks_per_executor));
 
-    const int num_exec = __get_number_executor();
+    std::atomic<std::size_t> cursor(0);
 
-    __execute_grid(num_exec, [&](int id, int num_executor){
-                range<Iterator> my_range = take_splice(global_range, id, num_executor);
-                fun(my_range.begin(), my_range.end());
+    __execute_grid(config, num_exec, [&](int id, int num_executor){
+        (void) id;
+        (void) num_executor;
+
+        std::size_t chunk_begin, chunk_end;
+        while(_next_schedule_chunk(config, cursor, n_elems, n_exec, dynamic_chunk, chunk_begin, chunk_end)){
+            fun(begin_it + chunk_begin, begin_it + chunk_end);
+        }
     });
 }
 
-} // detail
 
+// random access ranges: static slices or chunks of the dynamic schedules
+template<typename Iterator, typename Function>
+inline void _parallel_for_range(const execution_config & config, Iterator begin_it, Iterator end_it, Function & fun,
+                                std::random_access_iterator_tag){
+    const std::size_t n_elems = static_cast<std::size_t>(std::distance(begin_it, end_it));
+    const int num_exec = static_cast<int>(__get_number_slices(config, n_elems));
 
+    if(num_exec <= 1){
+        fun(begin_it, end_it);
+        return;
+    }
 
-/// for_each algorithm
-template<typename ExecPolicy, typename Iterator, typename RangeFunction>
-inline void for_range(ExecPolicy && policy, Iterator begin_it, Iterator end_it, RangeFunction fun){
-    if( detail::is_parallel_policy(policy) ){
-        detail::_omp_parallel_for_range(begin_it, end_it, fun);
+    if(config.schedule != schedule_type::static_split){
+        _parallel_for_range_chunks(config, num_exec, begin_it, n_elems, fun);
         return;
     }
 
-   fun(begin_it, end_it);
-}
+    range<Iterator> global_range(begin_it, end_it);
 
-/// parallel count_if algorithm
-template< class ExecutionPolicy, class InputIterator, class UnaryPredicate >
-typename std::iterator_traits<InputIterator>::difference_type
-    count_if( ExecutionPolicy&& policy, InputIterator first, InputIterator last, UnaryPredicate p ){
+    __execute_grid(config, num_exec, [&](int id, int num_executor){
+                range<Iterator> my_range = take_splice(global_range, id, num_executor);
+                fun(my_range.begin(), my_range.end());
+    });
+}
 
-    typedef typename std::iterator_traits<InputIterator>::difference_type counter_type;
+// non random access ranges: segmented iteration, walked only once
+template<typename Iterator, typename Function, typename Tag>
+inline void _parallel_for_range(const execution_config & config, Iterator begin_it, Iterator end_it, Function & fun,
+                                Tag){
+    const int num_exec = __get_number_executor(config);
 
-    static_assert(std::is_same< typename std::iterator_traits<InputIterator>::iterator_category, std::random_access_iterator_tag>::value , "parallel::count requires random_access_iterator");
+    if(num_exec <= 1 || begin_it == end_it){
+        fun(begin_it, end_it);
+        return;
+    }
 
-    if( detail::is_parallel_policy(policy) ){
+    _segmented_for_range(config, num_exec, begin_it, end_it, fun);
+}
 
-        const std::size_t nelems = std::distance(first, last);
-        std::atomic<uint64_t> counter(0);
 
-        const int number_executor = detail::__get_number_executor();
+/// for_each algorithm
+template<typename Iterator, typename Function>
+inline void _omp_parallel_for_range(const execution_config & config, Iterator begin_it, Iterator end_it, Function fun){
+    _parallel_for_range(config, begin_it, end_it, fun, typename std::iterator_traits<Iterator>::iterator_category());
+}
 
-        detail::__execute_grid(number_executor, [&](int id, int number_executor){
-           std::size_t nelem_per_slice = nelems / number_executor;
+} // detail
 
-           InputIterator my_begin = first + (id * nelem_per_slice);
-           InputIterator my_end = ( ((id +1) == number_executor) ? (last): (my_begin + nelem_per_slice));
 
-           counter += std::count_if(my_begin, my_end, p);
-        });
 
-        return counter_type(counter.load());
-    }else{
-        return std::count_if(first, last, p);
+/// for_each algorithm
+template<typename ExecPolicy, typename Iterator, typename RangeFunction>
+inline void for_range(ExecPolicy && policy, Iterator begin_it, Iterator end_it, RangeFunction fun){
+    if( detail::is_parallel_policy(policy) ){
+        detail::_omp_parallel_for_range(detail::get_execution_config(policy), begin_it, end_it, fun);
+        return;
     }
-}
-
-/// parallel count algorithm
-template< class ExecutionPolicy, class InputIterator, class T >
-typename std::iterator_traits<InputIterator>::difference_type
-    count( ExecutionPolicy&& policy, InputIterator first, InputIterator last, const T &value ){
-    using value_type = typename std::iterator_traits<InputIterator>::value_type;
-
-    return count_if(std::move(policy),
-                    first, last,
-                    [&value](const value_type & v){
-                        return (v == static_cast<value_type>(value));
-                    }
-    );
 
+   fun(begin_it, end_it);
 }
 
 
 
 
-
 } // parallel
 
 
@@ -0,0 +1,360 @@
+/**
+ * Copyright (c) 2018, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+#ifndef PARALLEL_COMPACTION_GENERIC_HPP
+#define PARALLEL_COMPACTION_GENERIC_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+#include <hadoken/parallel/algorithm.hpp>
+#include <hadoken/utility/range.hpp>
+#include "parallel_generic_utils.hpp"
+
+
+namespace hadoken{
+
+
+namespace parallel{
+
+
+namespace detail{
+
+
+// stream compaction
+//
+// the compactions run in three steps over the static slices of __execute_grid:
+//  - select: each slice evaluates its predicate once per element, keeps the result
+//    in a flag and counts its selected elements
+//  - scan: the exclusive scan of the counts gives the output offset of every slice
+//  - scatter: each slice writes its elements in order from its offset,
+//    the output is stable whatever the number of slices
+
+
+// true if all the iterators are random access, the compactions need
+// to index their output, the other iterators run sequentially
+template<typename... Iterators>
+struct _compact_random_access;
+
+template<>
+struct _compact_random_access<> : public std::true_type{};
+
+template<typename Iterator, typename... Iterators>
+struct _compact_random_access<Iterator, Iterators...> : public std::integral_constant<bool,
+        std::is_same<typename std::iterator_traits<Iterator>::iterator_category, std::random_access_iterator_tag>::value
+        && _compact_random_access<Iterators...>::value>{};
+
+
+// select step
+//
+// flags[i] = select(first + i, i) for every element, returns the output offset of
+// every slice followed by the total number of selected elements
+template<typename RandomIt, typename Select>
+inline std::vector<std::size_t> _compact_select(const execution_config & config, std::size_t n_slices,
+                                                RandomIt first, RandomIt last,
+                                                std::vector<unsigned char> & flags, Select & select){
+    const range<RandomIt> global_range(first, last);
+    std::vector<padded_value<std::size_t> > counts(n_slices);
+
+    flags.resize(global_range.size());
+
+    __execute_grid(config, static_cast<int>(n_slices), [&](int id, int num_executor){
+        const range<RandomIt> my_range = take_splice(global_range, id, num_executor);
+        std::size_t offset = static_cast<std::size_t>(std::distance(first, my_range.begin()));
+
+        std::size_t n_selected = 0;
+        for(RandomIt it = my_range.begin(); it != my_range.end(); ++it, ++offset){
+            const unsigned char selected = select(it, offset) ? 1 : 0;
+            flags[offset] = selected;
+            n_selected += selected;
+        }
+        counts[id].value = n_selected;
+    });
+
+    std::vector<std::size_t> offsets(n_slices + 1, 0);
+    for(std::size_t i = 0; i < n_slices; ++i){
+        offsets[i+1] = offsets[i] + counts[i].value;
+    }
+    return offsets;
+}
+
+
+// scatter step
+//
+// every element of the slice id is passed in order to selected(it, rank) or rejected(it, rank),
+// rank is its position among all the selected, respectively rejected, elements of the range
+template<typename RandomIt, typename Selected, typename Rejected>
+inline void _compact_scatter(const execution_config & config, std::size_t n_slices,
+                             RandomIt first, RandomIt last,
+                             const std::vector<unsigned char> & flags, const std::vector<std::size_t> & offsets,
+                             Selected selected, Rejected rejected){
+    const range<RandomIt> global_range(first, last);
+
+    __execute_grid(config, static_cast<int>(n_slices), [&](int id, int num_executor){
+        const range<RandomIt> my_range = take_splice(global_range, id, num_executor);
+        std::size_t offset = static_cast<std::size_t>(std::distance(first, my_range.begin()));
+
+        std::size_t selected_rank = offsets[id];
+        std::size_t rejected_rank = offset - offsets[id];
+        for(RandomIt it = my_range.begin(); it != my_range.end(); ++it, ++offset){
+            if(flags[offset]){
+                selected(it, selected_rank++);
+            }else{
+                rejected(it, rejected_rank++);
+            }
+        }
+    });
+}
+
+
+// in place compaction, keeps the elements for which select(it, offset) is true
+//
+// select is evaluated for all the elements before any of them moves, it can
+// look at the neighbours of it ( e.g unique ).
+// The slices compact their elements in parallel to their own front, the fronts
+// are then moved down in slice order: the overlapping moves go to lower addresses,
+// they are sequential but only touch the kept elements
+template<typename RandomIt, typename Select>
+inline RandomIt _compact_in_place(const execution_config & config, std::size_t n_slices,
+                                  RandomIt first, RandomIt last, Select select){
+    const range<RandomIt> global_range(first, last);
+
+    std::vector<unsigned char> flags;
+    const std::vector<std::size_t> offsets = _compact_select(config, n_slices, first, last, flags, select);
+
+    __execute_grid(config, static_cast<int>(n_slices), [&](int id, int num_executor){
+        const range<RandomIt> my_range = take_splice(global_range, id, num_executor);
+        std::size_t offset = static_cast<std::size_t>(std::distance(first, my_range.begin()));
+
+        RandomIt out = my_range.begin();
+        for(RandomIt it = my_range.begin(); it != my_range.end(); ++it, ++offset){
+            if(flags[offset]){
+                if(out != it){
+                    *out = std::move(*it);
+                }
+                ++out;
+            }
+        }
+    });
+
+    for(std::size_t id = 1; id < n_slices; ++id){
+        const range<RandomIt> my_range = take_splice(global_range, static_cast<int>(id), static_cast<int>(n_slices));
+        const RandomIt d_first = first + offsets[id];
+        if(d_first != my_range.begin()){
+            std::move(my_range.begin(), my_range.begin() + (offsets[id+1] - offsets[id]), d_first);
+        }
+    }
+
+    return first + offsets[n_slices];
+}
+
+
+// stable partition through a temporary buffer: the selected elements then the rejected ones
+template<typename RandomIt, typename UnaryPredicate>
+inline RandomIt _stable_partition(const execution_config & config, std::size_t n_slices,
+                                  RandomIt first, RandomIt last, UnaryPredicate & p){
+    typedef typename std::iterator_traits<RandomIt>::value_type value_type;
+
+    std::vector<unsigned char> flags;
+    auto select = [&](RandomIt it, std::size_t){ return static_cast<bool>(p(*it)); };
+    const std::vector<std::size_t> offsets = _compact_select(config, n_slices, first, last, flags, select);
+    const std::size_t n_selected = offsets[n_slices];
+
+    std::vector<value_type> buffer(std::make_move_iterator(first), std::make_move_iterator(last));
+
+    _compact_scatter(config, n_slices, buffer.begin(), buffer.end(), flags, offsets,
+                     [&](typename std::vector<value_type>::iterator it, std::size_t rank){
+                        first[rank] = std::move(*it);
+                     },
+                     [&](typename std::vector<value_type>::iterator it, std::size_t rank){
+                        first[n_selected + rank] = std::move(*it);
+                     });
+
+    return first + n_selected;
+}
+
+
+template<typename ForwardIt, typename UnaryPredicate>
+inline ForwardIt _sequential_partition(ForwardIt first, ForwardIt last, UnaryPredicate & p, std::false_type /* stable */){
+    return std::partition(first, last, p);
+}
+
+template<typename BidirIt, typename UnaryPredicate>
+inline BidirIt _sequential_partition(BidirIt first, BidirIt last, UnaryPredicate & p, std::true_type /* stable */){
+    return std::stable_partition(first, last, p);
+}
+
+
+// sequential fallbacks, non random access iterators
+template<typename ExecutionPolicy, typename InputIt, typename OutputIt, typename UnaryPredicate>
+inline OutputIt _copy_if(ExecutionPolicy && policy, InputIt first, InputIt last, OutputIt d_first, UnaryPredicate & p,
+                         std::false_type /* random access */){
+    (void) policy;
+    return std::copy_if(first, last, d_first, p);
+}
+
+template<typename ExecutionPolicy, typename ForwardIt, typename UnaryPredicate>
+inline ForwardIt _remove_if(ExecutionPolicy && policy, ForwardIt first, ForwardIt last, UnaryPredicate & p,
+                            std::false_type /* random access */){
+    (void) policy;
+    return std::remove_if(first, last, p);
+}
+
+template<bool Stable, typename ExecutionPolicy, typename BidirIt, typename UnaryPredicate>
+inline BidirIt _partition(ExecutionPolicy && policy, BidirIt first, BidirIt last, UnaryPredicate & p,
+                          std::false_type /* random access */){
+    (void) policy;
+    return _sequential_partition(first, last, p, std::integral_constant<bool, Stable>());
+}
+
+template<typename ExecutionPolicy, typename ForwardIt, typename BinaryPredicate>
+inline ForwardIt _unique(ExecutionPolicy && policy, ForwardIt first, ForwardIt last, BinaryPredicate & p,
+                         std::false_type /* random access */){
+    (void) policy;
+    return std::unique(first, last, p);
+}
+
+
+template<typename ExecutionPolicy, typename InputIt, typename OutputIt, typename UnaryPredicate>
+inline OutputIt _copy_if(ExecutionPolicy && policy, InputIt first, InputIt last, OutputIt d_first, UnaryPredicate & p,
+                         std::true_type /* random access */){
+    const execution_config config = get_execution_config(policy);
+    const std::size_t n_slices = is_parallel_policy(policy) ? __get_number_slices(config, static_cast<std::size_t>(last - first)) : 1;
+    if(n_slices <= 1){
+        return std::copy_if(first, last, d_first, p);
+    }
+
+    std::vector<unsigned char> flags;
+    auto select = [&](InputIt it, std::size_t){ return static_cast<bool>(p(*it)); };
+    const std::vector<std::size_t> offsets = _compact_select(config, n_slices, first, last, flags, select);
+
+    _compact_scatter(config, n_slices, first, last, flags, offsets,
+                     [&](InputIt it, std::size_t rank){ d_first[rank] = *it; },
+                     [](InputIt, std::size_t){});
+
+    return d_first + offsets[n_slices];
+}
+
+template<typename ExecutionPolicy, typename RandomIt, typename UnaryPredicate>
+inline RandomIt _remove_if(ExecutionPolicy && policy, RandomIt first, RandomIt last, UnaryPredicate & p,
+                           std::true_type /* random access */){
+    const execution_config config = get_execution_config(policy);
+    const std::size_t n_slices = is_parallel_policy(policy) ? __get_number_slices(config, static_cast<std::size_t>(last - first)) : 1;
+    if(n_slices <= 1){
+        return std::remove_if(first, last, p);
+    }
+
+    return _compact_in_place(config, n_slices, first, last,
+                             [&](RandomIt it, std::size_t){ return !p(*it); });
+}
+
+// the parallel partition is always stable
+template<bool Stable, typename ExecutionPolicy, typename RandomIt, typename UnaryPredicate>
+inline RandomIt _partition(ExecutionPolicy && policy, RandomIt first, RandomIt last, UnaryPredicate & p,
+                           std::true_type /* random access */){
+    const execution_config config = get_execution_config(policy);
+    const std::size_t n_slices = is_parallel_policy(policy) ? __get_number_slices(config, static_cast<std::size_t>(last - first)) : 1;
+    if(n_slices <= 1){
+        return _sequential_partition(first, last, p, std::integral_constant<bool, Stable>());
+    }
+
+    return _stable_partition(config, n_slices, first, last, p);
+}
+
+template<typename ExecutionPolicy, typename RandomIt, typename BinaryPredicate>
+inline RandomIt _unique(ExecutionPolicy && policy, RandomIt first, RandomIt last, BinaryPredicate & p,
+                        std::true_type /* random access */){
+    const execution_config config = get_execution_config(policy);
+    const std::size_t n_slices = is_parallel_policy(policy) ? __get_number_slices(config, static_cast<std::size_t>(last - first)) : 1;
+    if(n_slices <= 1){
+        return std::unique(first, last, p);
+    }
+
+    // an element is kept when it is not equivalent to its predecessor in the input
+    return _compact_in_place(config, n_slices, first, last,
+                             [&](RandomIt it, std::size_t offset){ return offset == 0 || !p(*(it - 1), *it); });
+}
+
+
+} // detail
+
+
+
+template< class ExecutionPolicy, class InputIt, class OutputIt, class UnaryPredicate >
+inline OutputIt copy_if( ExecutionPolicy&& policy, InputIt first, InputIt last, OutputIt d_first, UnaryPredicate p ){
+    return detail::_copy_if(std::forward<ExecutionPolicy>(policy), first, last, d_first, p,
+                            detail::_compact_random_access<InputIt, OutputIt>());
+}
+
+
+template< class ExecutionPolicy, class ForwardIt, class UnaryPredicate >
+inline ForwardIt remove_if( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryPredicate p ){
+    return detail::_remove_if(std::forward<ExecutionPolicy>(policy), first, last, p,
+                              detail::_compact_random_access<ForwardIt>());
+}
+
+
+template< class ExecutionPolicy, class ForwardIt, class UnaryPredicate >
+inline ForwardIt partition( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryPredicate p ){
+    return detail::_partition<false>(std::forward<ExecutionPolicy>(policy), first, last, p,
+                                     detail::_compact_random_access<ForwardIt>());
+}
+
+
+template< class ExecutionPolicy, class BidirIt, class UnaryPredicate >
+inline BidirIt stable_partition( ExecutionPolicy&& policy, BidirIt first, BidirIt last, UnaryPredicate p ){
+    return detail::_partition<true>(std::forward<ExecutionPolicy>(policy), first, last, p,
+                                    detail::_compact_random_access<BidirIt>());
+}
+
+
+template< class ExecutionPolicy, class ForwardIt, class BinaryPredicate >
+inline ForwardIt unique( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, BinaryPredicate p ){
+    return detail::_unique(std::forward<ExecutionPolicy>(policy), first, last, p,
+                           detail::_compact_random_access<ForwardIt>());
+}
+
+template< class ExecutionPolicy, class ForwardIt >
+inline ForwardIt unique( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last ){
+    using value_type = typename std::iterator_traits<ForwardIt>::value_type;
+
+    return ::hadoken::parallel::unique(std::forward<ExecutionPolicy>(policy), first, last, std::equal_to<value_type>());
+}
+
+
+} //parallel
+
+} // hadoken
+
+#endif // PARALLEL_COMPACTION_GENERIC_HPP
@@ -30,10 +30,14 @@
 #define PARALLEL_COUNT_GENERICS_BITS_HPP
 
 #include <algorithm>
+#include <functional>
+#include <iterator>
+#include <type_traits>
 #include <hadoken/parallel/algorithm.hpp>
 
 
 #include "parallel_generic_utils.hpp"
+#include "parallel_reduce_generic.hpp"
 
 
 namespace hadoken{
@@ -42,42 +46,24 @@ namespace hadoken{
 namespace parallel{
 
 
-namespace detail{
-
-// count_internal
-template< class ExecutionPolicy, class InputIterator, class UnaryPredicate >
-typename std::iterator_traits<InputIterator>::difference_type
- _internal_count_if( ExecutionPolicy&& policy, InputIterator first, InputIterator last,
-                      UnaryPredicate p ){
-    using result_type = typename std::iterator_traits<InputIterator>::difference_type;
-
-    if(is_parallel_policy(policy)){
-        std::atomic<result_type> res(0);
-
-        ::hadoken::parallel::for_range(std::forward<ExecutionPolicy>(policy), first, last, [&res, &p](InputIterator local_first,
-                                       InputIterator local_end){
-            result_type local_res = std::count_if(local_first, local_end, p);
-            res += local_res;
-        });
-        return res;
-    }else {
-        return std::count_if(first, last, p);
-    }
-}
-
-} // detail
-
-
 // parallel count_if algorithm
+//
+// per slice counters, combined with the reduce machinery
 template< class ExecutionPolicy, class InputIterator, class UnaryPredicate >
 typename std::iterator_traits<InputIterator>::difference_type
     count_if( ExecutionPolicy&& policy, InputIterator first, InputIterator last, UnaryPredicate p ){
-
-    return detail::_internal_count_if<ExecutionPolicy,
-            InputIterator,
-            UnaryPredicate>(std::move(policy),
-                                first, last,
-                                p);
+    static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>::value,
+                  "parallel::count_if requires at least a forward_iterator");
+    using counter_type = typename std::iterator_traits<InputIterator>::difference_type;
+    using reference = typename std::iterator_traits<InputIterator>::reference;
+
+    if(detail::is_parallel_policy(policy)){
+        return transform_reduce(std::forward<ExecutionPolicy>(policy), first, last, counter_type(0), std::plus<counter_type>(),
+                                [&p](reference v) -> counter_type {
+            return p(v) ? counter_type(1) : counter_type(0);
+        });
+    }
+    return std::count_if(first, last, p);
 }
 
 // parallel count algorithm
@@ -86,13 +72,12 @@ typename std::iterator_traits<InputIterator>::difference_type
     count( ExecutionPolicy&& policy, InputIterator first, InputIterator last, const T &value ){
     using value_type = typename std::iterator_traits<InputIterator>::value_type;
 
-    return detail::_internal_count_if<ExecutionPolicy,
-            InputIterator>(std::move(policy),
-                                first, last,
-                            [&value](const value_type & v){
-        return (v == static_cast<value_type>(value));
-    });
-
+    return count_if(std::forward<ExecutionPolicy>(policy),
+                    first, last,
+                    [&value](const value_type & v){
+                        return (v == static_cast<value_type>(value));
+                    }
+    );
 }
 
 
@@ -100,4 +85,4 @@ typename std::iterator_traits<InputIterator>::difference_type
 
 } // hadoken
 
-#endif // PARALLEL_ALGORITHM_GENERICS_HPP
+#endif // PARALLEL_COUNT_GENERICS_BITS_HPP
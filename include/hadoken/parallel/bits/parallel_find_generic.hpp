@@ -0,0 +1,200 @@
+/**
+ * Copyright (c) 2018, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+#ifndef PARALLEL_FIND_GENERIC_HPP
+#define PARALLEL_FIND_GENERIC_HPP
+
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+
+
+#include <hadoken/parallel/algorithm.hpp>
+#include <hadoken/thread/spinlock.hpp>
+#include "parallel_generic_utils.hpp"
+#include "parallel_segmented_generic.hpp"
+
+
+namespace hadoken{
+
+
+namespace parallel{
+
+
+namespace detail{
+
+
+// number of elements tested between two checks of the cancellation
+constexpr std::size_t find_check_interval = 1024;
+
+
+//
+// shared state of a cooperative search
+//
+// best is the offset of the lowest match found so far, it is
+// read by all the executors between two chunks: an executor stops
+// as soon as it can not find a better match
+//
+// FirstMatch: the lowest match is required ( find ), otherwise
+// any match stops all the executors ( any_of, all_of, none_of )
+//
+template<bool FirstMatch, typename Iterator>
+class find_state{
+public:
+    static constexpr std::size_t not_found = std::numeric_limits<std::size_t>::max();
+
+    inline find_state(Iterator last) : _best(not_found), _lock(), _best_it(last){}
+
+    /// true if no match can be found anymore at or after offset
+    inline bool cancelled(std::size_t offset) const{
+        const std::size_t best = _best.load(std::memory_order_relaxed);
+        return FirstMatch ? (best <= offset) : (best != not_found);
+    }
+
+    inline bool has_match() const{
+        return _best.load(std::memory_order_relaxed) != not_found;
+    }
+
+    inline void found(std::size_t offset, Iterator it){
+        std::lock_guard<thread::spin_lock> l(_lock);
+        if(offset < _best.load(std::memory_order_relaxed)){
+            _best_it = it;
+            _best.store(offset, std::memory_order_relaxed);
+        }
+    }
+
+    inline Iterator result(){
+        std::lock_guard<thread::spin_lock> l(_lock);
+        return _best_it;
+    }
+
+private:
+    std::atomic<std::size_t> _best;
+    thread::spin_lock _lock;
+    Iterator _best_it;
+};
+
+
+// search [first, last), offset elements after the beginning of the range,
+// the cancellation is checked every find_check_interval elements
+template<bool FirstMatch, typename Iterator, typename UnaryPredicate>
+inline void _find_in_chunk(find_state<FirstMatch, Iterator> & state, Iterator first, Iterator last, std::size_t offset,
+                           UnaryPredicate & p){
+    while(first != last){
+        if(state.cancelled(offset)){
+            return;
+        }
+
+        for(std::size_t i = 0; i < find_check_interval && first != last; ++i, ++first, ++offset){
+            if(p(*first)){
+                state.found(offset, first);
+                return;
+            }
+        }
+    }
+}
+
+
+template<bool FirstMatch, typename ExecutionPolicy, typename InputIterator, typename UnaryPredicate>
+inline InputIterator _internal_find_if(ExecutionPolicy && policy, InputIterator first, InputIterator last, UnaryPredicate & p){
+    static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>::value,
+                  "parallel::find_if, any_of, all_of and none_of require at least a forward_iterator");
+
+    typedef typename std::iterator_traits<InputIterator>::iterator_category category;
+
+    find_state<FirstMatch, InputIterator> state(last);
+
+    if(std::is_same<category, std::random_access_iterator_tag>::value){
+        hadoken::parallel::for_range(std::forward<ExecutionPolicy>(policy), first, last,
+                                     [&](InputIterator local_first, InputIterator local_last){
+            _find_in_chunk(state, local_first, local_last, static_cast<std::size_t>(std::distance(first, local_first)), p);
+        });
+        return state.result();
+    }
+
+    // chunks are handed out in order: once a match is found,
+    // the chunks not taken yet can only contain later matches
+    const execution_config config = get_execution_config(policy);
+    segmented_cursor<InputIterator> cursor(first, last, config.grain);
+
+    __execute_grid(config, __get_number_executor(config), [&](int id, int num_executor){
+        (void) id;
+        (void) num_executor;
+
+        InputIterator chunk_first, chunk_last;
+        std::size_t offset, index;
+        while(state.has_match() == false && cursor.next(chunk_first, chunk_last, offset, index)){
+            _find_in_chunk(state, chunk_first, chunk_last, offset, p);
+        }
+    });
+
+    return state.result();
+}
+
+
+} // detail
+
+
+template< class ExecutionPolicy, class InputIterator, class UnaryPredicate >
+inline InputIterator find_if( ExecutionPolicy&& policy, InputIterator first, InputIterator last, UnaryPredicate p ){
+    if(detail::is_parallel_policy(policy)){
+        return detail::_internal_find_if<true>(std::forward<ExecutionPolicy>(policy), first, last, p);
+    }
+    return std::find_if(first, last, p);
+}
+
+
+template< class ExecutionPolicy, class InputIterator, class UnaryPredicate >
+inline InputIterator find_if_not( ExecutionPolicy&& policy, InputIterator first, InputIterator last, UnaryPredicate p ){
+    using reference = typename std::iterator_traits<InputIterator>::reference;
+
+    return find_if(std::forward<ExecutionPolicy>(policy), first, last, [&p](reference v){
+        return !p(v);
+    });
+}
+
+
+template< class ExecutionPolicy, class InputIterator, class T >
+inline InputIterator find( ExecutionPolicy&& policy, InputIterator first, InputIterator last, const T & value ){
+    using reference = typename std::iterator_traits<InputIterator>::reference;
+
+    return find_if(std::forward<ExecutionPolicy>(policy), first, last, [&value](reference v){
+        return v == value;
+    });
+}
+
+
+} //parallel
+
+} // hadoken
+
+#endif // PARALLEL_FIND_GENERIC_HPP
@@ -30,8 +30,12 @@
 #define PARALLEL_GENERIC_UTILS_HPP
 
 #include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
 
-
+#include <hadoken/config/platform_config.hpp>
 #include <hadoken/parallel/algorithm.hpp>
 
 namespace hadoken{
@@ -43,6 +47,20 @@ namespace parallel{
 namespace detail{
 
 
+// implemented by the threading backend
+inline int __get_number_executor();
+
+inline int __get_number_executor(const execution_config & config);
+
+inline std::size_t __get_number_slices(const execution_config & config, std::size_t n_elems);
+
+template<typename Function>
+inline void __execute_grid(int num_executor, Function fun);
+
+template<typename Function>
+inline void __execute_grid(const execution_config & config, int num_executor, Function fun);
+
+
 template<typename Iterator, typename Size>
 inline Iterator get_end_iterator(Iterator first, Size n){
     std::advance(first, n);
@@ -61,6 +79,58 @@ inline bool is_parallel_policy(const ExecPolicy & policy){
 }
 
 
+// configuration of a policy, default configuration for the non configurable ones
+template<typename ExecPolicy>
+inline execution_config _get_execution_config(const ExecPolicy & policy, std::true_type){
+    return policy.config();
+}
+
+template<typename ExecPolicy>
+inline execution_config _get_execution_config(const ExecPolicy & policy, std::false_type){
+    (void) policy;
+    return execution_config();
+}
+
+template<typename ExecPolicy>
+inline execution_config get_execution_config(const ExecPolicy & policy){
+    return _get_execution_config(policy,
+                                 std::integral_constant<bool, std::is_base_of<configurable_policy<ExecPolicy>, ExecPolicy>::value>());
+}
+
+
+// iterators over contiguous storage: pointers and std::vector iterators,
+// their elements can be accessed through a pointer in the vectorized kernels
+template<typename Iterator, typename Value,
+         bool NotVector = (std::is_void<Value>::value || std::is_same<Value, bool>::value)>
+struct _is_vector_iterator : public std::false_type{};
+
+template<typename Iterator, typename Value>
+struct _is_vector_iterator<Iterator, Value, false> : public std::integral_constant<bool,
+        std::is_same<Iterator, typename std::vector<Value>::iterator>::value
+        || std::is_same<Iterator, typename std::vector<Value>::const_iterator>::value>{};
+
+template<typename Iterator>
+struct is_contiguous_iterator : public std::integral_constant<bool,
+        std::is_pointer<Iterator>::value
+        || _is_vector_iterator<Iterator, typename std::iterator_traits<Iterator>::value_type>::value>{};
+
+
+// number of elements of type T in a block of HADOKEN_SIMD_ALIGNMENT bytes,
+// the fixed trip count of the inner loops of the vectorized kernels
+template<typename T>
+struct simd_block_size : public std::integral_constant<std::size_t,
+        (sizeof(T) < HADOKEN_SIMD_ALIGNMENT) ? (HADOKEN_SIMD_ALIGNMENT / sizeof(T)) : 1>{};
+
+
+// per executor value, padded to a cache line to avoid false sharing
+// when each executor writes its own slot
+template<typename T>
+struct padded_value{
+    T value;
+    char _padding[HADOKEN_CACHE_LINE_SIZE - (sizeof(T) % HADOKEN_CACHE_LINE_SIZE)];
+};
+
+
 
 
 } //detail
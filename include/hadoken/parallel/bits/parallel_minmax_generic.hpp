@@ -0,0 +1,321 @@
+/**
+ * Copyright (c) 2018, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+#ifndef PARALLEL_MINMAX_GENERIC_HPP
+#define PARALLEL_MINMAX_GENERIC_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+
+#include <hadoken/config/platform_config.hpp>
+#include <hadoken/parallel/algorithm.hpp>
+#include <hadoken/thread/spinlock.hpp>
+#include "parallel_generic_utils.hpp"
+#include "parallel_segmented_generic.hpp"
+
+
+namespace hadoken{
+
+
+namespace parallel{
+
+
+namespace detail{
+
+
+// lane-wise extremums of a contiguous arithmetic range of n > 0 elements
+//
+// every lane keeps its own minimum and maximum, the comparisons of a block
+// are independent and vectorized, the lanes are reduced at the end.
+// Returns false if the range contains a NaN: a NaN seeded in a lane is never
+// replaced, the extremums are then meaningless
+template<bool WantMin, bool WantMax, typename T>
+inline bool _minmax_value_kernel(const T* in, std::size_t n, T & min_value, T & max_value){
+    const std::size_t block = simd_block_size<T>::value;
+
+    std::size_t i = 0;
+    int unordered = 0;
+    min_value = max_value = in[0];
+
+    if(n >= 2 * block){
+        T lo[block], hi[block];
+        for(std::size_t j = 0; j < block; ++j){
+            lo[j] = hi[j] = in[j];
+        }
+
+        for(i = block; i + block <= n; i += block){
+            HADOKEN_PRAGMA_SIMD
+            for(std::size_t j = 0; j < block; ++j){
+                const T v = in[i + j];
+                unordered |= (v != v) ? 1 : 0;
+                if(WantMin){
+                    lo[j] = (v < lo[j]) ? v : lo[j];
+                }
+                if(WantMax){
+                    hi[j] = (hi[j] < v) ? v : hi[j];
+                }
+            }
+        }
+
+        for(std::size_t j = 0; j < block; ++j){
+            unordered |= (in[j] != in[j]) ? 1 : 0;
+            min_value = (lo[j] < min_value) ? lo[j] : min_value;
+            max_value = (max_value < hi[j]) ? hi[j] : max_value;
+        }
+    }
+
+    for(; i < n; ++i){
+        unordered |= (in[i] != in[i]) ? 1 : 0;
+        min_value = (in[i] < min_value) ? in[i] : min_value;
+        max_value = (max_value < in[i]) ? in[i] : max_value;
+    }
+
+    return unordered == 0;
+}
+
+
+// generic slice of a non empty range
+template<bool WantMin, bool WantMax, bool LastMax, typename ForwardIt, typename Compare>
+inline std::pair<ForwardIt, ForwardIt> _minmax_slice(ForwardIt first, ForwardIt last, Compare & comp,
+                                                     std::false_type /* vectorized */){
+    if(WantMin && WantMax){
+        return std::minmax_element(first, last, comp);
+    }
+    if(WantMin){
+        return std::make_pair(std::min_element(first, last, comp), last);
+    }
+    return std::make_pair(last, std::max_element(first, last, comp));
+}
+
+
+// true if the block of simd_block_size elements at in contains value
+template<typename T>
+inline bool _block_contains(const T* in, const T & value){
+    const std::size_t block = simd_block_size<T>::value;
+
+    int hits = 0;
+    HADOKEN_PRAGMA_SIMD
+    for(std::size_t j = 0; j < block; ++j){
+        hits |= (in[j] == value) ? 1 : 0;
+    }
+    return hits != 0;
+}
+
+
+// position of the first ( or last ) element equal to value in [0, n), n if none
+// whole blocks are tested first, the matching block is then scanned
+template<bool Last, typename T>
+inline std::size_t _find_value_position(const T* in, std::size_t n, const T & value){
+    const std::size_t block = simd_block_size<T>::value;
+
+    if(Last){
+        std::size_t end = n;
+        while(end >= block && _block_contains(in + end - block, value) == false){
+            end -= block;
+        }
+        for(std::size_t i = end; i > 0; --i){
+            if(in[i - 1] == value){
+                return i - 1;
+            }
+        }
+        return n;
+    }
+
+    std::size_t begin = 0;
+    while(begin + block <= n && _block_contains(in + begin, value) == false){
+        begin += block;
+    }
+    for(std::size_t i = begin; i < n; ++i){
+        if(in[i] == value){
+            return i;
+        }
+    }
+    return n;
+}
+
+
+// contiguous arithmetic slice of a non empty range under par_vec:
+// the extremum values are searched first, then their position
+//
+// NaN values are not ordered, a slice containing one falls back on the generic slice
+template<bool WantMin, bool WantMax, bool LastMax, typename ForwardIt, typename Compare>
+inline std::pair<ForwardIt, ForwardIt> _minmax_slice(ForwardIt first, ForwardIt last, Compare & comp,
+                                                     std::true_type /* vectorized */){
+    typedef typename std::iterator_traits<ForwardIt>::value_type value_type;
+
+    const value_type* in = std::addressof(*first);
+    const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+
+    value_type min_value, max_value;
+    if(_minmax_value_kernel<WantMin, WantMax>(in, n, min_value, max_value) == false){
+        return _minmax_slice<WantMin, WantMax, LastMax>(first, last, comp, std::false_type());
+    }
+
+    const std::size_t min_pos = WantMin ? _find_value_position<false>(in, n, min_value) : 0;
+    const std::size_t max_pos = WantMax ? _find_value_position<LastMax>(in, n, max_value) : 0;
+
+    return std::make_pair(WantMin ? (first + min_pos) : last, WantMax ? (first + max_pos) : last);
+}
+
+
+//
+// best extremums of the slices
+//
+// the candidates are ordered by value then by position: the result only
+// depends on the range, never on the slicing nor on the executor timing.
+// The minimum is the first smallest element, the maximum the first ( max_element )
+// or the last ( minmax_element ) largest element, as for the std algorithms
+//
+template<bool LastMax, typename ForwardIt, typename Compare>
+class minmax_state{
+public:
+    inline minmax_state(ForwardIt last, Compare & comp) :
+        _lock(), _comp(comp), _min(last), _max(last), _min_offset(0), _max_offset(0), _has_min(false), _has_max(false){}
+
+    inline void candidate_min(ForwardIt it, std::size_t offset){
+        std::lock_guard<thread::spin_lock> l(_lock);
+        if(_has_min == false || _comp(*it, *_min) || (!_comp(*_min, *it) && offset < _min_offset)){
+            _min = it;
+            _min_offset = offset;
+            _has_min = true;
+        }
+    }
+
+    inline void candidate_max(ForwardIt it, std::size_t offset){
+        std::lock_guard<thread::spin_lock> l(_lock);
+        const bool better_position = LastMax ? (offset > _max_offset) : (offset < _max_offset);
+        if(_has_max == false || _comp(*_max, *it) || (!_comp(*it, *_max) && better_position)){
+            _max = it;
+            _max_offset = offset;
+            _has_max = true;
+        }
+    }
+
+    inline std::pair<ForwardIt, ForwardIt> result() const{
+        return std::make_pair(_min, _max);
+    }
+
+private:
+    thread::spin_lock _lock;
+    Compare & _comp;
+    ForwardIt _min, _max;
+    std::size_t _min_offset, _max_offset;
+    bool _has_min, _has_max;
+};
+
+
+template<bool WantMin, bool WantMax, bool LastMax, typename ExecutionPolicy, typename ForwardIt, typename Compare>
+inline std::pair<ForwardIt, ForwardIt> _internal_minmax_element(ExecutionPolicy && policy, ForwardIt first, ForwardIt last,
+                                                                Compare comp){
+    typedef typename std::iterator_traits<ForwardIt>::value_type value_type;
+    typedef typename std::integral_constant<bool,
+            std::is_same<typename std::decay<ExecutionPolicy>::type, parallel_vector_execution_policy>::value
+            && is_contiguous_iterator<ForwardIt>::value
+            && std::is_arithmetic<value_type>::value
+            && std::is_same<Compare, std::less<value_type> >::value> vectorized;
+
+    if(is_parallel_policy(policy) == false || first == last){
+        return (first == last) ? std::make_pair(last, last) : _minmax_slice<WantMin, WantMax, LastMax>(first, last, comp, std::false_type());
+    }
+
+    minmax_state<LastMax, ForwardIt, Compare> state(last, comp);
+
+    _for_range_offset(std::forward<ExecutionPolicy>(policy), first, last,
+                      [&](ForwardIt local_first, ForwardIt local_last, std::size_t offset){
+        if(local_first == local_last){
+            return;
+        }
+
+        const std::pair<ForwardIt, ForwardIt> local = _minmax_slice<WantMin, WantMax, LastMax>(local_first, local_last, comp, vectorized());
+
+        if(WantMin){
+            state.candidate_min(local.first, offset + static_cast<std::size_t>(std::distance(local_first, local.first)));
+        }
+        if(WantMax){
+            state.candidate_max(local.second, offset + static_cast<std::size_t>(std::distance(local_first, local.second)));
+        }
+    });
+
+    return state.result();
+}
+
+
+} // detail
+
+
+template< class ExecutionPolicy, class ForwardIt, class Compare >
+inline ForwardIt min_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, Compare comp ){
+    return detail::_internal_minmax_element<true, false, false>(std::forward<ExecutionPolicy>(policy), first, last, comp).first;
+}
+
+template< class ExecutionPolicy, class ForwardIt >
+inline ForwardIt min_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last ){
+    using value_type = typename std::iterator_traits<ForwardIt>::value_type;
+
+    return ::hadoken::parallel::min_element(std::forward<ExecutionPolicy>(policy), first, last, std::less<value_type>());
+}
+
+
+template< class ExecutionPolicy, class ForwardIt, class Compare >
+inline ForwardIt max_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, Compare comp ){
+    return detail::_internal_minmax_element<false, true, false>(std::forward<ExecutionPolicy>(policy), first, last, comp).second;
+}
+
+template< class ExecutionPolicy, class ForwardIt >
+inline ForwardIt max_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last ){
+    using value_type = typename std::iterator_traits<ForwardIt>::value_type;
+
+    return ::hadoken::parallel::max_element(std::forward<ExecutionPolicy>(policy), first, last, std::less<value_type>());
+}
+
+
+template< class ExecutionPolicy, class ForwardIt, class Compare >
+inline std::pair<ForwardIt, ForwardIt> minmax_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, Compare comp ){
+    return detail::_internal_minmax_element<true, true, true>(std::forward<ExecutionPolicy>(policy), first, last, comp);
+}
+
+template< class ExecutionPolicy, class ForwardIt >
+inline std::pair<ForwardIt, ForwardIt> minmax_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last ){
+    using value_type = typename std::iterator_traits<ForwardIt>::value_type;
+
+    return ::hadoken::parallel::minmax_element(std::forward<ExecutionPolicy>(policy), first, last, std::less<value_type>());
+}
+
+
+} //parallel
+
+} // hadoken
+
+#endif // PARALLEL_MINMAX_GENERIC_HPP
@@ -29,12 +29,13 @@
 #ifndef PARALLEL_NONE_ANY_ALL_GENERIC_HPP
 #define PARALLEL_NONE_ANY_ALL_GENERIC_HPP
 
-#include <atomic>
 #include <algorithm>
+#include <iterator>
 #include <hadoken/parallel/algorithm.hpp>
 
 
 #include "parallel_generic_utils.hpp"
+#include "parallel_find_generic.hpp"
 
 
 namespace hadoken{
@@ -43,27 +44,15 @@ namespace hadoken{
 namespace parallel{
 
 
-namespace detail{
-
-
-
-} // detail
-
-
 template< class ExecutionPolicy, class InputIterator, class UnaryPredicate >
 inline bool all_of( ExecutionPolicy&& policy, InputIterator first, InputIterator last, UnaryPredicate p ){
+    using reference = typename std::iterator_traits<InputIterator>::reference;
 
     if(detail::is_parallel_policy(policy)){
-        std::atomic<bool>  res(true);
-
-        hadoken::parallel::for_range(std::forward<ExecutionPolicy>(policy), first, last, [&res, &p](InputIterator local_first, InputIterator local_end){
-            const bool local_res = std::all_of(local_first, local_end, p);
-
-            if(local_res == false){
-                res.store(false);
-            }
-        });
-        return res.load();
+        auto not_p = [&p](reference v){
+            return !p(v);
+        };
+        return detail::_internal_find_if<false>(std::forward<ExecutionPolicy>(policy), first, last, not_p) == last;
     }else{
         return std::all_of(first, last, p);
     }
@@ -74,16 +63,7 @@ template< class ExecutionPolicy, class InputIterator, class UnaryPredicate >
 inline bool any_of( ExecutionPolicy&& policy, InputIterator first, InputIterator last, UnaryPredicate p ){
 
     if(detail::is_parallel_policy(policy)){
-        std::atomic<bool>  res(false);
-
-        hadoken::parallel::for_range(std::forward<ExecutionPolicy>(policy), first, last, [&res, &p](InputIterator local_first, InputIterator local_end){
-            const bool local_res = std::any_of(local_first, local_end, p);
-
-            if(local_res == true){
-                res.store(true);
-            }
-        });
-        return res.load();
+        return detail::_internal_find_if<false>(std::forward<ExecutionPolicy>(policy), first, last, p) != last;
     }else{
         return std::any_of(first, last, p);
     }
@@ -96,16 +76,7 @@ template< class ExecutionPolicy, class InputIterator, class UnaryPredicate >
 inline bool none_of( ExecutionPolicy&& policy, InputIterator first, InputIterator last, UnaryPredicate p ){
 
     if(detail::is_parallel_policy(policy)){
-        std::atomic<bool>  res(true);
-
-        hadoken::parallel::for_range(std::forward<ExecutionPolicy>(policy), first, last, [&res, &p](InputIterator local_first, InputIterator local_end){
-            const bool local_res = std::none_of(local_first, local_end, p);
-
-            if(local_res == false){
-                res.store(false);
-            }
-        });
-        return res.load();
+        return detail::_internal_find_if<false>(std::forward<ExecutionPolicy>(policy), first, last, p) == last;
     }else{
         return std::none_of(first, last, p);
     }
@@ -29,15 +29,16 @@
 #ifndef PARALLEL_NUMERIC_GENERIC_HPP
 #define PARALLEL_NUMERIC_GENERIC_HPP
 
-#include <atomic>
 #include <algorithm>
-#include <cmath>
-#include <mutex>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
+#include <vector>
 
 
-#include <hadoken/thread/spinlock.hpp>
-
 #include <hadoken/parallel/algorithm.hpp>
+#include <hadoken/utility/range.hpp>
 #include "parallel_generic_utils.hpp"
 
 
@@ -49,81 +50,135 @@ namespace parallel{
 
 namespace detail{
 
-template< class ExecutionPolicy, class InputIt, class OutputIt,
-class BinaryOperation>
-OutputIt _internal_inclusive_scan( ExecutionPolicy&& policy,
-                         InputIt first, InputIt last, OutputIt d_first,
-                         BinaryOperation binary_op){
-    (void) (policy);
-    using value_type = typename std::iterator_traits<OutputIt>::value_type;
-    using tuple_it_val = std::tuple<OutputIt, value_type>;
-                             
-    std::size_t n_elems = std::distance(first, last);
-    OutputIt d_end = d_first;
-    std::advance(d_end, n_elems);
-    
-    if(n_elems ==0){
+
+// identity transformation for the non transform scans
+struct scan_identity{
+    template<typename T>
+    inline T && operator()(T && v) const{
+        return std::forward<T>(v);
+    }
+};
+
+
+// prefix of a slice: the reduction of all the previous slices ( and of init )
+template<typename T>
+struct scan_prefix{
+    T value;
+    bool valid;
+};
+
+
+// sequential scan of [first, last) on top of prefix
+//
+// inclusive: out[i] = prefix + in[0] + ... + in[i]
+// exclusive: out[i] = prefix + in[0] + ... + in[i-1], prefix must be valid
+template<bool Exclusive, typename T, class InputIt, class OutputIt, class BinaryOperation, class UnaryOperation>
+inline OutputIt _scan_slice(InputIt first, InputIt last, OutputIt d_first,
+                            scan_prefix<T> prefix, BinaryOperation & binary_op, UnaryOperation & unary_op){
+    if(first == last){
         return d_first;
     }
 
-        
-    std::vector<tuple_it_val> limits_vec;
-    hadoken::thread::spin_lock _limit_lock;
-    limits_vec.reserve(64);
+    if(Exclusive){
+        T acc = prefix.value;
+        for(; first != last; ++first, ++d_first){
+            // read before write: support in place scan
+            T next = binary_op(acc, unary_op(*first));
+            *d_first = std::move(acc);
+            acc = std::move(next);
+        }
+        return d_first;
+    }
 
-    // first local inclusive scan 
-    for_range(policy, first, last, [&](InputIt local_first, InputIt local_last){
-        std::size_t distance_from_first = std::distance(first, local_first);
-        std::size_t local_n_elems = std::distance(local_first, local_last);
-        
-        OutputIt local_d_first = d_first;
-        std::advance(local_d_first, distance_from_first);
-        
-        std::partial_sum(local_first, local_last, local_d_first, binary_op);
-        
-        OutputIt d_local_end;
-        std::advance(local_d_first, local_n_elems-1);
-        d_local_end = local_d_first;
-        std::advance(d_local_end, 1);
-        
-        {
-            std::lock_guard<hadoken::thread::spin_lock> _l(_limit_lock);
-            limits_vec.push_back(std::make_tuple(d_local_end, *local_d_first));
+    T acc = prefix.valid ? T(binary_op(prefix.value, unary_op(*first))) : T(unary_op(*first));
+    *d_first = acc;
+    for(++first, ++d_first; first != last; ++first, ++d_first){
+        acc = binary_op(acc, unary_op(*first));
+        *d_first = acc;
+    }
+    return d_first;
+}
+
+
+// reduce then scan, in two passes:
+//  - pass 1: each slice reduces its elements in its own slot
+//  - the slot reductions are combined sequentially in the slice prefixes
+//  - pass 2: each slice scans its elements on top of its prefix
+//
+// no lock, no synchronization except the barrier between the two passes
+template<bool Exclusive, typename T, class ExecutionPolicy, class InputIt, class OutputIt, class BinaryOperation, class UnaryOperation>
+OutputIt _internal_scan(ExecutionPolicy&& policy, InputIt first, InputIt last, OutputIt d_first,
+                        BinaryOperation binary_op, UnaryOperation unary_op, scan_prefix<T> init){
+
+    const std::size_t n_elems = static_cast<std::size_t>(std::distance(first, last));
+
+    const execution_config config = get_execution_config(policy);
+
+    std::size_t n_slices = 1;
+    if(is_parallel_policy(policy)){
+        n_slices = __get_number_slices(config, n_elems);
+    }
+
+    if(n_slices <= 1){
+        return _scan_slice<Exclusive>(first, last, d_first, init, binary_op, unary_op);
+    }
+
+    const range<InputIt> global_range(first, last);
+    std::vector<padded_value<scan_prefix<T> > > slots(n_slices);
+
+    // pass 1: local reductions
+    __execute_grid(config, static_cast<int>(n_slices), [&](int id, int num_executor){
+        const range<InputIt> my_range = take_splice(global_range, id, num_executor);
+
+        InputIt it = my_range.begin();
+        T acc = unary_op(*it);
+        for(++it; it != my_range.end(); ++it){
+            acc = binary_op(acc, unary_op(*it));
         }
+
+        slots[id].value.value = std::move(acc);
+        slots[id].value.valid = true;
     });
-    
-    std::sort(limits_vec.begin(), limits_vec.end(), [](const tuple_it_val & v1, const tuple_it_val & v2){
-       return std::get<0>(v1) < std::get<0>(v2); 
-    });
-    
 
-    // post sum of each chunk partial sum
-    for_range(policy, d_first, d_end, [&](InputIt local_first, InputIt local_last){
-        
-        if(local_first < std::get<0>(limits_vec[0]))
-            return;
-        
-        value_type val = std::get<1>(limits_vec[0]);
-        
-        auto limit_it = limits_vec.begin();
-        std::advance(limit_it, 1);
-        
-        
-        while(local_first < local_last){
-            while(local_first >= std::get<0>(*limit_it) && limit_it < limits_vec.end()){
-                val = binary_op(val, std::get<1>(*limit_it));
-                limit_it++;
-            }
-            
-            *local_first = binary_op(val, *local_first);
-            local_first++;
-        };
+    // exclusive scan of the slot reductions: prefix of each slice
+    scan_prefix<T> prefix = init;
+    for(std::size_t id = 0; id < n_slices; ++id){
+        scan_prefix<T> & slot = slots[id].value;
+        T reduction = std::move(slot.value);
+
+        slot = prefix;
+        prefix.value = prefix.valid ? T(binary_op(prefix.value, reduction)) : std::move(reduction);
+        prefix.valid = true;
+    }
+
+    // pass 2: local scans on top of the slice prefix
+    __execute_grid(config, static_cast<int>(n_slices), [&](int id, int num_executor){
+        const range<InputIt> my_range = take_splice(global_range, id, num_executor);
 
+        OutputIt local_d_first = d_first;
+        std::advance(local_d_first, std::distance(first, my_range.begin()));
+
+        _scan_slice<Exclusive>(my_range.begin(), my_range.end(), local_d_first, slots[id].value, binary_op, unary_op);
     });
+
+    std::advance(d_first, n_elems);
     return d_first;
+}
 
+
+template<typename T>
+inline scan_prefix<T> make_scan_prefix(){
+    scan_prefix<T> prefix = { T(), false };
+    return prefix;
+}
+
+template<typename T>
+inline scan_prefix<T> make_scan_prefix(T init){
+    scan_prefix<T> prefix = { std::move(init), true };
+    return prefix;
 }
 
+
 } // detail
 
 // inclusive scan algorithm
@@ -141,13 +196,64 @@ class BinaryOperation>
 OutputIt inclusive_scan( ExecutionPolicy&& policy,
                          InputIt first, InputIt last, OutputIt d_first,
                          BinaryOperation binary_op){
+    using value_type = typename std::iterator_traits<InputIt>::value_type;
+
     if(detail::is_parallel_policy(policy)){
-        // to improve
-        return detail::_internal_inclusive_scan(std::forward<ExecutionPolicy>(policy), first, last, d_first, binary_op);
+        return detail::_internal_scan<false>(std::forward<ExecutionPolicy>(policy), first, last, d_first,
+                                             binary_op, detail::scan_identity(), detail::make_scan_prefix<value_type>());
     }
     return std::partial_sum(first, last, d_first, binary_op);
 }
 
+// inclusive scan algorithm with initial value
+template< class ExecutionPolicy, class InputIt, class OutputIt,
+class BinaryOperation, class T >
+OutputIt inclusive_scan( ExecutionPolicy&& policy,
+                         InputIt first, InputIt last, OutputIt d_first,
+                         BinaryOperation binary_op, T init){
+    return detail::_internal_scan<false>(std::forward<ExecutionPolicy>(policy), first, last, d_first,
+                                         binary_op, detail::scan_identity(), detail::make_scan_prefix<T>(std::move(init)));
+}
+
+// exclusive scan algorithm
+template< class ExecutionPolicy, class InputIt, class OutputIt, class T >
+OutputIt exclusive_scan( ExecutionPolicy&& policy,
+                         InputIt first, InputIt last, OutputIt d_first,
+                         T init){
+    return exclusive_scan(std::forward<ExecutionPolicy>(policy), first, last, d_first, std::move(init), std::plus<T>());
+}
+
+// exclusive scan algorithm binary op
+template< class ExecutionPolicy, class InputIt, class OutputIt, class T, class BinaryOperation >
+OutputIt exclusive_scan( ExecutionPolicy&& policy,
+                         InputIt first, InputIt last, OutputIt d_first,
+                         T init, BinaryOperation binary_op){
+    return detail::_internal_scan<true>(std::forward<ExecutionPolicy>(policy), first, last, d_first,
+                                        binary_op, detail::scan_identity(), detail::make_scan_prefix<T>(std::move(init)));
+}
+
+// transform inclusive scan algorithm
+template< class ExecutionPolicy, class InputIt, class OutputIt,
+class BinaryOperation, class UnaryOperation >
+OutputIt transform_inclusive_scan( ExecutionPolicy&& policy,
+                                   InputIt first, InputIt last, OutputIt d_first,
+                                   BinaryOperation binary_op, UnaryOperation unary_op){
+    using value_type = typename std::decay<decltype(unary_op(*first))>::type;
+
+    return detail::_internal_scan<false>(std::forward<ExecutionPolicy>(policy), first, last, d_first,
+                                         binary_op, unary_op, detail::make_scan_prefix<value_type>());
+}
+
+// transform inclusive scan algorithm with initial value
+template< class ExecutionPolicy, class InputIt, class OutputIt,
+class BinaryOperation, class UnaryOperation, class T >
+OutputIt transform_inclusive_scan( ExecutionPolicy&& policy,
+                                   InputIt first, InputIt last, OutputIt d_first,
+                                   BinaryOperation binary_op, UnaryOperation unary_op, T init){
+    return detail::_internal_scan<false>(std::forward<ExecutionPolicy>(policy), first, last, d_first,
+                                         binary_op, unary_op, detail::make_scan_prefix<T>(std::move(init)));
+}
+
 } //parallel
 
 } // hadoken
@@ -0,0 +1,317 @@
+/**
+ * Copyright (c) 2018, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+#ifndef PARALLEL_RADIX_SORT_GENERIC_HPP
+#define PARALLEL_RADIX_SORT_GENERIC_HPP
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+
+#include <hadoken/parallel/algorithm.hpp>
+#include "parallel_generic_utils.hpp"
+#include "parallel_numeric_generic.hpp"
+#include "parallel_sort_generic.hpp"
+
+
+namespace hadoken{
+
+
+namespace parallel{
+
+
+namespace detail{
+
+
+// one byte digit per pass
+constexpr std::size_t radix_digit_bits = 8;
+
+constexpr std::size_t radix_buckets = std::size_t(1) << radix_digit_bits;
+
+// below this number of elements per slice, the 256 counters and
+// write combining lines of a slice are not amortized
+constexpr std::size_t radix_sort_min_slice_size = 16384;
+
+// below this number of elements, a comparison sort is faster
+constexpr std::size_t radix_sort_min_size = 256;
+
+
+// keys as unsigned integers in the same order than the keys
+//
+// signed integers: the sign bit is flipped
+// floating points: positive values get their sign bit flipped, negative values all their bits,
+// -0.0 is before +0.0 and the NaN are at the extremities, depending on their sign
+template<typename Key, typename Enable = void>
+struct radix_key_traits{
+    static_assert(std::is_arithmetic<Key>::value, "radix sort requires integral or floating point keys");
+};
+
+template<typename Key>
+struct radix_key_traits<Key, typename std::enable_if<std::is_integral<Key>::value && std::is_unsigned<Key>::value>::type>{
+    static_assert(std::is_same<Key, bool>::value == false, "radix sort does not support bool keys");
+
+    typedef Key bits_type;
+
+    static inline bits_type to_bits(Key key){
+        return key;
+    }
+};
+
+template<typename Key>
+struct radix_key_traits<Key, typename std::enable_if<std::is_integral<Key>::value && std::is_signed<Key>::value>::type>{
+    typedef typename std::make_unsigned<Key>::type bits_type;
+
+    static inline bits_type to_bits(Key key){
+        return static_cast<bits_type>(static_cast<bits_type>(key) ^ (bits_type(1) << (sizeof(Key) * CHAR_BIT - 1)));
+    }
+};
+
+template<typename Key>
+struct radix_key_traits<Key, typename std::enable_if<std::is_floating_point<Key>::value>::type>{
+    static_assert(sizeof(Key) == sizeof(std::uint32_t) || sizeof(Key) == sizeof(std::uint64_t),
+                  "radix sort supports only 32 and 64 bits floating point keys");
+
+    typedef typename std::conditional<sizeof(Key) == sizeof(std::uint32_t), std::uint32_t, std::uint64_t>::type bits_type;
+
+    static inline bits_type to_bits(Key key){
+        bits_type bits;
+        std::memcpy(&bits, &key, sizeof(Key));
+
+        const bits_type sign = bits_type(1) << (sizeof(Key) * CHAR_BIT - 1);
+        return (bits & sign) ? bits_type(~bits) : bits_type(bits | sign);
+    }
+};
+
+
+template<typename Key>
+inline std::size_t _radix_digit(const Key & key, std::size_t shift){
+    return static_cast<std::size_t>((radix_key_traits<Key>::to_bits(key) >> shift) & (radix_buckets - 1));
+}
+
+
+// placeholder of the values for the sort of keys only
+struct radix_no_value{};
+
+
+// value moves, no-ops for the sort of keys only
+template<typename ValueSrc, typename ValueBuffer>
+inline void _radix_store_value(ValueSrc src, std::size_t i, ValueBuffer buffer, std::size_t pos, std::true_type /* with values */){
+    buffer[pos] = std::move(src[i]);
+}
+
+template<typename ValueSrc, typename ValueBuffer>
+inline void _radix_store_value(ValueSrc, std::size_t, ValueBuffer, std::size_t, std::false_type /* with values */){}
+
+
+template<typename ValueBuffer, typename ValueDst>
+inline void _radix_move_values(ValueBuffer buffer, std::size_t first, std::size_t last, ValueDst dst, std::size_t pos,
+                               std::true_type /* with values */){
+    std::move(buffer + first, buffer + last, dst + pos);
+}
+
+template<typename ValueBuffer, typename ValueDst>
+inline void _radix_move_values(ValueBuffer, std::size_t, std::size_t, ValueDst, std::size_t, std::false_type /* with values */){}
+
+
+// one counting sort pass on the digit at shift, from the src ranges to the dst ranges
+//
+//  - each slice counts its digits in a local histogram
+//  - the histograms are laid out bucket major and exclusive scanned:
+//    the result is the output offset of every ( bucket, slice ) pair
+//  - each slice scatters its elements, in order, from its offsets. The elements go through
+//    a write combining line per bucket, flushed a cache line at a time: the scatter
+//    writes full lines in 256 output streams instead of single elements
+//
+// returns false, without moving anything, when all the keys have the same digit
+template<typename WithValues, typename KeySrc, typename KeyDst, typename ValueSrc, typename ValueDst>
+inline bool _radix_pass(const execution_config & config, const std::vector<std::size_t> & bounds, std::size_t shift,
+                        KeySrc keys_src, KeyDst keys_dst, ValueSrc values_src, ValueDst values_dst,
+                        std::vector<std::size_t> & counts){
+    typedef typename std::iterator_traits<KeySrc>::value_type key_type;
+    typedef typename std::conditional<WithValues::value,
+            typename std::iterator_traits<ValueSrc>::value_type, radix_no_value>::type value_type;
+
+    const std::size_t n_slices = bounds.size() - 1;
+    const std::size_t n_elems = bounds.back();
+
+    __execute_grid(config, static_cast<int>(n_slices), [&](int id, int n_exec){
+        (void) n_exec;
+        std::size_t histogram[radix_buckets] = {};
+        for(std::size_t i = bounds[id]; i < bounds[id+1]; ++i){
+            histogram[_radix_digit(keys_src[i], shift)] += 1;
+        }
+        for(std::size_t b = 0; b < radix_buckets; ++b){
+            counts[b * n_slices + id] = histogram[b];
+        }
+    });
+
+    for(std::size_t b = 0; b < radix_buckets; ++b){
+        std::size_t total = 0;
+        for(std::size_t s = 0; s < n_slices; ++s){
+            total += counts[b * n_slices + s];
+        }
+        if(total == n_elems){
+            return false;
+        }
+    }
+
+    ::hadoken::parallel::exclusive_scan(seq, counts.begin(), counts.end(), counts.begin(), std::size_t(0));
+
+    __execute_grid(config, static_cast<int>(n_slices), [&](int id, int n_exec){
+        (void) n_exec;
+        const std::size_t line = simd_block_size<key_type>::value;
+
+        std::size_t offsets[radix_buckets], fill[radix_buckets] = {};
+        for(std::size_t b = 0; b < radix_buckets; ++b){
+            offsets[b] = counts[b * n_slices + id];
+        }
+
+        std::unique_ptr<key_type[]> key_lines(new key_type[radix_buckets * line]);
+        std::unique_ptr<value_type[]> value_lines(new value_type[WithValues::value ? radix_buckets * line : 0]);
+
+        for(std::size_t i = bounds[id]; i < bounds[id+1]; ++i){
+            const key_type key = keys_src[i];
+            const std::size_t b = _radix_digit(key, shift);
+            const std::size_t pos = b * line + fill[b];
+
+            key_lines[pos] = key;
+            _radix_store_value(values_src, i, value_lines.get(), pos, WithValues());
+
+            if(++fill[b] == line){
+                std::copy(key_lines.get() + b * line, key_lines.get() + (b + 1) * line, keys_dst + offsets[b]);
+                _radix_move_values(value_lines.get(), b * line, (b + 1) * line, values_dst, offsets[b], WithValues());
+                offsets[b] += line;
+                fill[b] = 0;
+            }
+        }
+
+        for(std::size_t b = 0; b < radix_buckets; ++b){
+            std::copy(key_lines.get() + b * line, key_lines.get() + b * line + fill[b], keys_dst + offsets[b]);
+            _radix_move_values(value_lines.get(), b * line, b * line + fill[b], values_dst, offsets[b], WithValues());
+        }
+    });
+
+    return true;
+}
+
+
+// parallel LSD radix sort, stable
+//
+// one pass per byte of the key, from the least significant one, the elements
+// go back and forth between the input ranges and temporary buffers. The passes
+// where all the keys have the same digit are skipped ( e.g small keys in a large type )
+template<typename WithValues, typename ExecutionPolicy, typename KeyIt, typename ValueIt>
+inline void _internal_radix_sort(ExecutionPolicy && policy, KeyIt keys_first, KeyIt keys_last, ValueIt values_first){
+    typedef typename std::iterator_traits<KeyIt>::value_type key_type;
+    typedef typename std::conditional<WithValues::value,
+            typename std::iterator_traits<ValueIt>::value_type, radix_no_value>::type value_type;
+
+    const std::size_t n_elems = static_cast<std::size_t>(std::distance(keys_first, keys_last));
+
+    if(n_elems < 2){
+        return;
+    }
+
+    if(WithValues::value == false && n_elems < radix_sort_min_size){
+        std::sort(keys_first, keys_last, [](const key_type & a, const key_type & b){
+            return radix_key_traits<key_type>::to_bits(a) < radix_key_traits<key_type>::to_bits(b);
+        });
+        return;
+    }
+
+    const execution_config config = get_execution_config(policy);
+
+    std::size_t n_slices = 1;
+    if(is_parallel_policy(policy)){
+        const std::size_t grain = std::max(config.grain, radix_sort_min_slice_size);
+        n_slices = std::max<std::size_t>(std::min<std::size_t>(__get_number_executor(config), n_elems / grain), 1);
+    }
+
+    const std::vector<std::size_t> bounds = _sort_slice_bounds(n_elems, n_slices);
+    std::vector<std::size_t> counts(radix_buckets * n_slices);
+
+    // default initialized: not touched before the first scatter
+    std::unique_ptr<key_type[]> keys_buffer(new key_type[n_elems]);
+    std::unique_ptr<value_type[]> values_buffer(new value_type[WithValues::value ? n_elems : 0]);
+
+    bool in_buffer = false;
+    for(std::size_t shift = 0; shift < sizeof(key_type) * CHAR_BIT; shift += radix_digit_bits){
+        bool moved;
+        if(in_buffer){
+            moved = _radix_pass<WithValues>(config, bounds, shift, keys_buffer.get(), keys_first,
+                                            values_buffer.get(), values_first, counts);
+        }else{
+            moved = _radix_pass<WithValues>(config, bounds, shift, keys_first, keys_buffer.get(),
+                                            values_first, values_buffer.get(), counts);
+        }
+        in_buffer = (moved) ? !in_buffer : in_buffer;
+    }
+
+    if(in_buffer){
+        __execute_grid(config, static_cast<int>(n_slices), [&](int id, int n_exec){
+            (void) n_exec;
+            std::copy(keys_buffer.get() + bounds[id], keys_buffer.get() + bounds[id+1], keys_first + bounds[id]);
+            _radix_move_values(values_buffer.get(), bounds[id], bounds[id+1], values_first, bounds[id], WithValues());
+        });
+    }
+}
+
+
+} // detail
+
+
+template< class ExecutionPolicy, class RandomIt >
+void radix_sort( ExecutionPolicy&& policy, RandomIt first, RandomIt last ){
+    static_assert(std::is_same< typename std::iterator_traits<RandomIt>::iterator_category, std::random_access_iterator_tag>::value , "parallel::radix_sort requires random_access_iterator");
+
+    detail::_internal_radix_sort<std::false_type>(std::forward<ExecutionPolicy>(policy), first, last,
+                                                  static_cast<detail::radix_no_value*>(nullptr));
+}
+
+
+template< class ExecutionPolicy, class RandomIt1, class RandomIt2 >
+void sort_by_key( ExecutionPolicy&& policy, RandomIt1 keys_first, RandomIt1 keys_last, RandomIt2 values_first ){
+    static_assert(std::is_same< typename std::iterator_traits<RandomIt1>::iterator_category, std::random_access_iterator_tag>::value
+                  && std::is_same< typename std::iterator_traits<RandomIt2>::iterator_category, std::random_access_iterator_tag>::value,
+                  "parallel::sort_by_key requires random_access_iterator");
+
+    detail::_internal_radix_sort<std::true_type>(std::forward<ExecutionPolicy>(policy), keys_first, keys_last, values_first);
+}
+
+
+} //parallel
+
+} // hadoken
+
+#endif // PARALLEL_RADIX_SORT_GENERIC_HPP
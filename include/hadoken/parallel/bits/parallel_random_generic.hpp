@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+#ifndef PARALLEL_RANDOM_GENERIC_BITS_HPP
+#define PARALLEL_RANDOM_GENERIC_BITS_HPP
+
+#include <iterator>
+#include <type_traits>
+
+#include <hadoken/parallel/algorithm.hpp>
+
+
+#include "parallel_generic_utils.hpp"
+
+
+namespace hadoken{
+
+
+namespace parallel{
+
+
+// parallel generate_random algorithm
+template< class ExecutionPolicy, class RandomIterator, class Engine >
+void generate_random( ExecutionPolicy&& policy, RandomIterator first, RandomIterator last, Engine & engine ){
+    static_assert(std::is_same< typename std::iterator_traits<RandomIterator>::iterator_category, std::random_access_iterator_tag>::value ,
+                  "parallel::generate_random requires random_access_iterator");
+
+    const std::size_t nelems = std::distance(first, last);
+
+    if(detail::is_parallel_policy(policy)){
+        // counter based engines seek in O(1): each subrange starts from its own
+        // offset in the stream, the result does not depend of the slicing
+        hadoken::parallel::for_range(policy, first, last, [&](RandomIterator local_begin, RandomIterator local_end){
+            Engine local_engine(engine);
+            local_engine.discard(std::distance(first, local_begin));
+            local_engine.generate(local_begin, local_end);
+        });
+
+        engine.discard(nelems);
+        return;
+    }
+
+    engine.generate(first, last);
+}
+
+
+} //parallel
+
+} // hadoken
+
+#endif // PARALLEL_RANDOM_GENERIC_BITS_HPP
@@ -0,0 +1,232 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+#ifndef PARALLEL_REDUCE_GENERIC_HPP
+#define PARALLEL_REDUCE_GENERIC_HPP
+
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+#include <hadoken/parallel/algorithm.hpp>
+#include <hadoken/utility/range.hpp>
+#include "parallel_generic_utils.hpp"
+#include "parallel_segmented_generic.hpp"
+
+
+namespace hadoken{
+
+
+namespace parallel{
+
+
+namespace detail{
+
+
+// number of independent accumulators of the unsequenced ( par_vec ) inner loop
+constexpr std::size_t reduce_unsequenced_lanes = 4;
+
+
+// reduction of a non empty range, left to right
+template<typename T, class InputIt, class ReduceOperation, class Transform>
+inline T _reduce_slice(InputIt first, InputIt last, std::size_t offset, ReduceOperation & reduce_op, Transform & transform,
+                       std::false_type /* unsequenced */){
+    T acc = transform(first, offset);
+    for(++first, ++offset; first != last; ++first, ++offset){
+        acc = reduce_op(std::move(acc), transform(first, offset));
+    }
+    return acc;
+}
+
+
+// reduction of a non empty range, with independent accumulators
+//
+// the lanes break the dependency chain of the accumulation and let
+// the compiler vectorize the loop. The order of the operations changes:
+// only for par_vec, where reduce_op is required to be associative and commutative
+template<typename T, class InputIt, class ReduceOperation, class Transform>
+inline T _reduce_slice(InputIt first, InputIt last, std::size_t offset, ReduceOperation & reduce_op, Transform & transform,
+                       std::true_type /* unsequenced */){
+    typedef typename std::iterator_traits<InputIt>::iterator_category category;
+
+    const std::size_t lanes = reduce_unsequenced_lanes;
+    const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+
+    if(std::is_same<category, std::random_access_iterator_tag>::value == false || n < 2 * lanes){
+        return _reduce_slice<T>(first, last, offset, reduce_op, transform, std::false_type());
+    }
+
+    T acc[lanes] = { transform(first, offset), transform(std::next(first, 1), offset + 1),
+                     transform(std::next(first, 2), offset + 2), transform(std::next(first, 3), offset + 3) };
+
+    std::size_t i = lanes;
+    for(; i + lanes <= n; i += lanes){
+        for(std::size_t l = 0; l < lanes; ++l){
+            acc[l] = reduce_op(std::move(acc[l]), transform(std::next(first, i + l), offset + i + l));
+        }
+    }
+    for(; i < n; ++i){
+        acc[0] = reduce_op(std::move(acc[0]), transform(std::next(first, i), offset + i));
+    }
+
+    return reduce_op(reduce_op(std::move(acc[0]), std::move(acc[1])), reduce_op(std::move(acc[2]), std::move(acc[3])));
+}
+
+
+// generic parallel reduction
+//
+// transform(it, offset) gives the value of the element at it, offset elements after first
+//
+// each slice of __execute_grid reduces its elements in its own slot, padded
+// to a cache line, the slots are combined in a tree in slice order
+template<typename T, class ExecutionPolicy, class InputIt, class ReduceOperation, class Transform>
+inline T _internal_reduce(ExecutionPolicy&& policy, InputIt first, InputIt last, T init,
+                          ReduceOperation reduce_op, Transform transform){
+    static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>::value,
+                  "parallel::reduce requires at least a forward_iterator");
+
+    typedef typename std::integral_constant<bool,
+            std::is_same<typename std::decay<ExecutionPolicy>::type, parallel_vector_execution_policy>::value> unsequenced;
+
+    typedef typename std::iterator_traits<InputIt>::iterator_category category;
+
+    const execution_config config = get_execution_config(policy);
+
+    // non random access ranges: single walk, the size is never computed
+    if(std::is_same<category, std::random_access_iterator_tag>::value == false && is_parallel_policy(policy)){
+        const int num_exec = __get_number_executor(config);
+        if(num_exec > 1 && first != last){
+            return _segmented_reduce<T>(config, num_exec, first, last, std::move(init), reduce_op,
+                                        [&](InputIt chunk_first, InputIt chunk_last, std::size_t offset) -> T {
+                return _reduce_slice<T>(chunk_first, chunk_last, offset, reduce_op, transform, std::false_type());
+            });
+        }
+    }
+
+    const std::size_t n_elems = static_cast<std::size_t>(std::distance(first, last));
+    if(n_elems == 0){
+        return init;
+    }
+
+    std::size_t n_slices = 1;
+    if(is_parallel_policy(policy)){
+        n_slices = __get_number_slices(config, n_elems);
+    }
+
+    if(n_slices <= 1){
+        return reduce_op(std::move(init), _reduce_slice<T>(first, last, 0, reduce_op, transform, unsequenced()));
+    }
+
+    const range<InputIt> global_range(first, last);
+
+    padded_value<T> proto = { init, {} };
+    std::vector<padded_value<T> > partials(n_slices, proto);
+
+    __execute_grid(config, static_cast<int>(n_slices), [&](int id, int num_executor){
+        const range<InputIt> my_range = take_splice(global_range, id, num_executor);
+        const std::size_t offset = static_cast<std::size_t>(std::distance(first, my_range.begin()));
+
+        partials[id].value = _reduce_slice<T>(my_range.begin(), my_range.end(), offset, reduce_op, transform, unsequenced());
+    });
+
+    // pairwise tree combination, the left operand always precedes the right one
+    for(std::size_t stride = 1; stride < n_slices; stride *= 2){
+        for(std::size_t i = 0; i + stride < n_slices; i += 2 * stride){
+            partials[i].value = reduce_op(std::move(partials[i].value), std::move(partials[i + stride].value));
+        }
+    }
+
+    return reduce_op(std::move(init), std::move(partials[0].value));
+}
+
+
+} // detail
+
+
+// reduce algorithm
+template< class ExecutionPolicy, class InputIt >
+typename std::iterator_traits<InputIt>::value_type
+    reduce( ExecutionPolicy&& policy, InputIt first, InputIt last ){
+    using value_type = typename std::iterator_traits<InputIt>::value_type;
+
+    return reduce(std::forward<ExecutionPolicy>(policy), first, last, value_type(), std::plus<value_type>());
+}
+
+// reduce algorithm with initial value
+template< class ExecutionPolicy, class InputIt, class T >
+T reduce( ExecutionPolicy&& policy, InputIt first, InputIt last, T init ){
+    return reduce(std::forward<ExecutionPolicy>(policy), first, last, std::move(init), std::plus<T>());
+}
+
+// reduce algorithm binary op
+template< class ExecutionPolicy, class InputIt, class T, class BinaryOperation >
+T reduce( ExecutionPolicy&& policy, InputIt first, InputIt last, T init, BinaryOperation binary_op ){
+    return detail::_internal_reduce<T>(std::forward<ExecutionPolicy>(policy), first, last, std::move(init), binary_op,
+                                       [](InputIt it, std::size_t) -> T { return *it; });
+}
+
+
+// transform_reduce algorithm, inner product of two ranges
+template< class ExecutionPolicy, class InputIt1, class InputIt2, class T >
+T transform_reduce( ExecutionPolicy&& policy, InputIt1 first1, InputIt1 last1, InputIt2 first2, T init ){
+    return transform_reduce(std::forward<ExecutionPolicy>(policy), first1, last1, first2, std::move(init),
+                            std::plus<T>(), std::multiplies<T>());
+}
+
+// transform_reduce algorithm on two ranges
+template< class ExecutionPolicy, class InputIt1, class InputIt2, class T, class BinaryReduceOp, class BinaryTransformOp >
+T transform_reduce( ExecutionPolicy&& policy, InputIt1 first1, InputIt1 last1, InputIt2 first2, T init,
+                    BinaryReduceOp reduce_op, BinaryTransformOp transform_op ){
+    static_assert(std::is_same< typename std::iterator_traits<InputIt2>::iterator_category, std::random_access_iterator_tag>::value ,
+                  "parallel::transform_reduce requires a random_access_iterator for the second range");
+
+    return detail::_internal_reduce<T>(std::forward<ExecutionPolicy>(policy), first1, last1, std::move(init), reduce_op,
+                                       [&transform_op, first2](InputIt1 it, std::size_t offset) -> T {
+        return transform_op(*it, first2[offset]);
+    });
+}
+
+// transform_reduce algorithm on one range
+template< class ExecutionPolicy, class InputIt, class T, class BinaryReduceOp, class UnaryTransformOp >
+T transform_reduce( ExecutionPolicy&& policy, InputIt first, InputIt last, T init,
+                    BinaryReduceOp reduce_op, UnaryTransformOp transform_op ){
+    return detail::_internal_reduce<T>(std::forward<ExecutionPolicy>(policy), first, last, std::move(init), reduce_op,
+                                       [&transform_op](InputIt it, std::size_t) -> T {
+        return transform_op(*it);
+    });
+}
+
+
+} //parallel
+
+} // hadoken
+
+#endif // PARALLEL_REDUCE_GENERIC_HPP
@@ -0,0 +1,218 @@
+/**
+ * Copyright (c) 2018, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+#ifndef PARALLEL_SEGMENTED_GENERIC_HPP
+#define PARALLEL_SEGMENTED_GENERIC_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+#include <hadoken/parallel/algorithm.hpp>
+#include <hadoken/thread/spinlock.hpp>
+#include "parallel_generic_utils.hpp"
+
+
+namespace hadoken{
+
+
+namespace parallel{
+
+
+namespace detail{
+
+
+// upper bound of the chunk size of the segmented iteration
+constexpr std::size_t segmented_max_chunk_size = 512;
+
+
+//
+// segmented iteration of a non random access range
+//
+// the range is walked only once: every executor takes the next chunk
+// from the shared cursor and advances it, then works on its chunk while
+// the others keep walking. The chunk size doubles from the grain up to
+// segmented_max_chunk_size, small ranges of expensive elements are
+// still spread over all the executors.
+//
+// the size of the range is never computed, the chunking only depends
+// on the grain: chunk indexes and offsets are deterministic
+//
+template<typename Iterator>
+class segmented_cursor{
+public:
+    inline segmented_cursor(Iterator first, Iterator last, std::size_t grain) :
+        _lock(),
+        _it(first),
+        _last(last),
+        _offset(0),
+        _index(0),
+        _chunk(grain),
+        _max_chunk(std::max(grain, segmented_max_chunk_size)){}
+
+    /// take the next chunk [chunk_first, chunk_last), offset elements after the beginning of the range
+    /// return false when the range is exhausted
+    inline bool next(Iterator & chunk_first, Iterator & chunk_last, std::size_t & offset, std::size_t & index){
+        std::lock_guard<thread::spin_lock> l(_lock);
+
+        if(_it == _last){
+            return false;
+        }
+
+        chunk_first = _it;
+        offset = _offset;
+        index = _index;
+
+        std::size_t n = 0;
+        for(; n < _chunk && _it != _last; ++n){
+            ++_it;
+        }
+        chunk_last = _it;
+
+        _offset += n;
+        _index += 1;
+        _chunk = std::min(_chunk * 2, _max_chunk);
+        return true;
+    }
+
+private:
+    segmented_cursor(const segmented_cursor &) = delete;
+    segmented_cursor & operator=(const segmented_cursor &) = delete;
+
+    thread::spin_lock _lock;
+    Iterator _it, _last;
+    std::size_t _offset, _index, _chunk, _max_chunk;
+};
+
+
+// for_range over a non random access range, fun(chunk_first, chunk_last) is called once per chunk
+template<typename Iterator, typename Function>
+inline void _segmented_for_range(const execution_config & config, int num_exec, Iterator first, Iterator last, Function & fun){
+    segmented_cursor<Iterator> cursor(first, last, config.grain);
+
+    __execute_grid(config, num_exec, [&](int id, int num_executor){
+        (void) id;
+        (void) num_executor;
+
+        Iterator chunk_first, chunk_last;
+        std::size_t offset, index;
+        while(cursor.next(chunk_first, chunk_last, offset, index)){
+            fun(chunk_first, chunk_last);
+        }
+    });
+}
+
+
+// for_range variant, fun(chunk_first, chunk_last, offset) also gets the position of
+// the subrange: computed in O(1) for random access ranges, given by the
+// segmented cursor for the others
+template<typename ExecutionPolicy, typename Iterator, typename Function>
+inline void _for_range_offset(ExecutionPolicy && policy, Iterator first, Iterator last, Function fun){
+    typedef typename std::iterator_traits<Iterator>::iterator_category category;
+
+    if(std::is_same<category, std::random_access_iterator_tag>::value){
+        hadoken::parallel::for_range(std::forward<ExecutionPolicy>(policy), first, last, [&](Iterator local_first, Iterator local_last){
+            fun(local_first, local_last, static_cast<std::size_t>(std::distance(first, local_first)));
+        });
+        return;
+    }
+
+    const execution_config config = get_execution_config(policy);
+    const int num_exec = is_parallel_policy(policy) ? __get_number_executor(config) : 1;
+
+    if(num_exec <= 1 || first == last){
+        fun(first, last, std::size_t(0));
+        return;
+    }
+
+    segmented_cursor<Iterator> cursor(first, last, config.grain);
+
+    __execute_grid(config, num_exec, [&](int id, int num_executor){
+        (void) id;
+        (void) num_executor;
+
+        Iterator chunk_first, chunk_last;
+        std::size_t offset, index;
+        while(cursor.next(chunk_first, chunk_last, offset, index)){
+            fun(chunk_first, chunk_last, offset);
+        }
+    });
+}
+
+
+// reduction over a non random access range
+//
+// every executor keeps the reductions of its chunks with their index, they are
+// combined in chunk order at the end: the result does not depend on the
+// distribution of the chunks over the executors
+template<typename T, typename Iterator, typename ReduceOperation, typename ChunkReduce>
+inline T _segmented_reduce(const execution_config & config, int num_exec, Iterator first, Iterator last, T init,
+                           ReduceOperation & reduce_op, ChunkReduce chunk_reduce){
+    typedef std::pair<std::size_t, T> chunk_result;
+
+    segmented_cursor<Iterator> cursor(first, last, config.grain);
+    std::vector<padded_value<std::vector<chunk_result> > > partials(num_exec);
+
+    __execute_grid(config, num_exec, [&](int id, int num_executor){
+        (void) num_executor;
+
+        Iterator chunk_first, chunk_last;
+        std::size_t offset, index;
+        while(cursor.next(chunk_first, chunk_last, offset, index)){
+            partials[id].value.emplace_back(index, chunk_reduce(chunk_first, chunk_last, offset));
+        }
+    });
+
+    std::vector<chunk_result> results;
+    for(auto & partial : partials){
+        std::move(partial.value.begin(), partial.value.end(), std::back_inserter(results));
+    }
+
+    std::sort(results.begin(), results.end(), [](const chunk_result & a, const chunk_result & b){
+        return a.first < b.first;
+    });
+
+    for(auto & res : results){
+        init = reduce_op(std::move(init), std::move(res.second));
+    }
+    return init;
+}
+
+
+} // detail
+
+} //parallel
+
+} // hadoken
+
+#endif // PARALLEL_SEGMENTED_GENERIC_HPP
@@ -31,6 +31,9 @@
 
 #include <atomic>
 #include <algorithm>
+#include <iterator>
+#include <vector>
+
 #include <hadoken/parallel/algorithm.hpp>
 
 
@@ -45,6 +48,177 @@ namespace parallel{
 
 namespace detail{
 
+// below this number of elements per slice, sorting in parallel is not worth it
+constexpr std::size_t parallel_sort_min_slice_size = 4096;
+
+
+// split [0, n_elems) in n_slices contiguous chunks, same partitioning than take_splice
+inline std::vector<std::size_t> _sort_slice_bounds(std::size_t n_elems, std::size_t n_slices){
+    std::vector<std::size_t> bounds(n_slices + 1);
+    const std::size_t base = n_elems / n_slices;
+    const std::size_t modulo = n_elems % n_slices;
+
+    for(std::size_t i = 0; i <= n_slices; ++i){
+        bounds[i] = base * i + std::min(modulo, i);
+    }
+    return bounds;
+}
+
+
+// merge path co-rank
+// return the number of elements of [a, a + a_size) that appear
+// in the first k elements of std::merge(a, a + a_size, b, b + b_size)
+template<typename RandomIt1, typename RandomIt2, typename Compare>
+inline std::size_t _merge_co_rank(std::size_t k, RandomIt1 a, std::size_t a_size,
+                                  RandomIt2 b, std::size_t b_size, Compare & comp){
+    std::size_t low = (k > b_size) ? (k - b_size) : 0;
+    std::size_t high = std::min(k, a_size);
+
+    while(low < high){
+        const std::size_t i = low + (high - low) / 2;
+        const std::size_t j = k - i;
+
+        if( !comp(b[j-1], a[i]) ){
+            low = i + 1;
+        }else{
+            high = i;
+        }
+    }
+    return low;
+}
+
+
+// number of elements taken from the first run of the pair of runs
+// containing the output position pos, when the pair is merged
+// positions on a pair boundary are not cut and return 0
+template<typename RandomIt, typename Compare>
+inline std::size_t _merge_cut(RandomIt src, const std::vector<std::size_t> & bounds,
+                              std::size_t pos, Compare & comp){
+    const std::size_t n_runs = bounds.size() - 1;
+
+    for(std::size_t r = 0; r < n_runs; r += 2){
+        const std::size_t a_begin = bounds[r];
+        const std::size_t a_end = bounds[r+1];
+        const std::size_t b_end = ((r + 2) <= n_runs) ? bounds[r+2] : a_end;
+
+        if(pos < b_end){
+            return _merge_co_rank(pos - a_begin, src + a_begin, a_end - a_begin,
+                                  src + a_end, b_end - a_end, comp);
+        }
+    }
+    return 0;
+}
+
+
+// merge by pairs the sorted runs [bounds[r], bounds[r+1]) of src into dst
+// only the output positions [out_first, out_last) are produced by this call,
+// cut_first and cut_last are the _merge_cut of out_first and out_last
+template<typename RandomIt1, typename RandomIt2, typename Compare>
+inline void _merge_runs_slice(RandomIt1 src, RandomIt2 dst, const std::vector<std::size_t> & bounds,
+                              std::size_t out_first, std::size_t out_last,
+                              std::size_t cut_first, std::size_t cut_last, Compare & comp){
+    const std::size_t n_runs = bounds.size() - 1;
+
+    for(std::size_t r = 0; r < n_runs; r += 2){
+        const std::size_t a_begin = bounds[r];
+        const std::size_t a_end = bounds[r+1];
+        const std::size_t b_end = ((r + 2) <= n_runs) ? bounds[r+2] : a_end;
+
+        const std::size_t low = std::max(out_first, a_begin);
+        const std::size_t high = std::min(out_last, b_end);
+
+        if(low >= high){
+            continue;
+        }
+
+        // a cut is only required when the slice boundary falls inside the pair
+        const std::size_t i_low = (low == a_begin) ? 0 : cut_first;
+        const std::size_t i_high = (high == b_end) ? (a_end - a_begin) : cut_last;
+        const std::size_t j_low = (low - a_begin) - i_low;
+        const std::size_t j_high = (high - a_begin) - i_high;
+
+        RandomIt1 a = src + a_begin, b = src + a_end;
+        std::merge(std::make_move_iterator(a + i_low), std::make_move_iterator(a + i_high),
+                   std::make_move_iterator(b + j_low), std::make_move_iterator(b + j_high),
+                   dst + low, comp);
+    }
+}
+
+
+// one merge round: runs of src are merged by pairs into dst, all executors
+// work on an equal share of the output through a merge path partitioning
+//
+// the cuts are computed before any element is moved from src
+template<typename RandomIt1, typename RandomIt2, typename Compare>
+inline void _merge_round(const execution_config & config, RandomIt1 src, RandomIt2 dst, std::size_t n_elems, int n_slices,
+                         std::vector<std::size_t> & bounds, Compare & comp){
+    const std::vector<std::size_t> out_bounds = _sort_slice_bounds(n_elems, n_slices);
+    std::vector<std::size_t> cuts(out_bounds.size());
+
+    for(std::size_t i = 0; i < out_bounds.size(); ++i){
+        cuts[i] = _merge_cut(src, bounds, out_bounds[i], comp);
+    }
+
+    __execute_grid(config, n_slices, [&](int id, int n_exec){
+        (void) n_exec;
+        _merge_runs_slice(src, dst, bounds, out_bounds[id], out_bounds[id+1], cuts[id], cuts[id+1], comp);
+    });
+
+    std::vector<std::size_t> next_bounds;
+    next_bounds.reserve(bounds.size() / 2 + 2);
+    for(std::size_t r = 0; r < bounds.size() - 1; r += 2){
+        next_bounds.push_back(bounds[r]);
+    }
+    next_bounds.push_back(bounds.back());
+    bounds.swap(next_bounds);
+}
+
+
+// parallel merge sort
+//  - each slice is sorted locally with std::sort in a temporary buffer
+//  - sorted slices are merged by pairs in log2(n_slices) rounds,
+//    each round being distributed over all the executors
+template<typename RandomIt, typename Compare>
+inline void _internal_parallel_sort(const execution_config & config, RandomIt first, RandomIt last, Compare comp){
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+
+    const std::size_t n_elems = std::distance(first, last);
+    const std::size_t grain = std::max(config.grain, parallel_sort_min_slice_size);
+    const int n_slices = static_cast<int>(std::min<std::size_t>(__get_number_executor(config), n_elems / grain));
+
+    if(n_slices <= 1){
+        std::sort(first, last, comp);
+        return;
+    }
+
+    // slices are sorted in the buffer, the first merge round moves them back in place
+    std::vector<value_type> buffer(std::make_move_iterator(first), std::make_move_iterator(last));
+    std::vector<std::size_t> bounds = _sort_slice_bounds(n_elems, n_slices);
+
+    __execute_grid(config, n_slices, [&](int id, int n_exec){
+        (void) n_exec;
+        std::sort(buffer.begin() + bounds[id], buffer.begin() + bounds[id+1], comp);
+    });
+
+    bool sorted_in_buffer = true;
+
+    while(bounds.size() > 2){
+        if(sorted_in_buffer){
+            _merge_round(config, buffer.begin(), first, n_elems, n_slices, bounds, comp);
+        }else{
+            _merge_round(config, first, buffer.begin(), n_elems, n_slices, bounds, comp);
+        }
+        sorted_in_buffer = !sorted_in_buffer;
+    }
+
+    if(sorted_in_buffer){
+        const std::vector<std::size_t> out_bounds = _sort_slice_bounds(n_elems, n_slices);
+        __execute_grid(config, n_slices, [&](int id, int n_exec){
+            (void) n_exec;
+            std::move(buffer.begin() + out_bounds[id], buffer.begin() + out_bounds[id+1], first + out_bounds[id]);
+        });
+    }
+}
 
 
 } // detail
@@ -52,16 +226,20 @@ namespace detail{
 // sort algorithm
 template< class ExecutionPolicy, class RandomIt >
 void sort( ExecutionPolicy&& policy, RandomIt first, RandomIt last ){
-    // temporary dummy implementation
-    (void) policy;
-    std::sort(first, last);
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+
+    ::hadoken::parallel::sort(std::forward<ExecutionPolicy>(policy), first, last, std::less<value_type>());
 }
 
 // sort algorithm with comparator
 template< class ExecutionPolicy, class RandomIt, class Compare >
 void sort( ExecutionPolicy&& policy, RandomIt first, RandomIt last, Compare comp ){
-    // temporary dummy implementation
-    (void) policy;
+    static_assert(std::is_same< typename std::iterator_traits<RandomIt>::iterator_category, std::random_access_iterator_tag>::value , "parallel::sort requires random_access_iterator");
+
+    if(detail::is_parallel_policy(policy)){
+        detail::_internal_parallel_sort(detail::get_execution_config(policy), first, last, comp);
+        return;
+    }
     std::sort(first, last, comp);
 }
 
@@ -31,10 +31,16 @@
 
 #include <tuple>
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
 
 #include <boost/iterator/zip_iterator.hpp>
 #include <boost/tuple/tuple.hpp>
 
+#include <hadoken/config/platform_config.hpp>
 #include <hadoken/parallel/algorithm.hpp>
 
 
@@ -46,13 +52,111 @@ namespace hadoken{
 
 namespace parallel{
 
+
+namespace detail{
+
+
+// number of scalar iterations before out reaches HADOKEN_SIMD_ALIGNMENT,
+// 0 if the alignment can not be reached by steps of one element
+template<typename T>
+inline std::size_t _simd_peel_size(const T* out, std::size_t n){
+    const std::size_t misalignment = static_cast<std::size_t>(reinterpret_cast<std::uintptr_t>(out) % HADOKEN_SIMD_ALIGNMENT);
+
+    if(misalignment == 0 || misalignment % sizeof(T) != 0){
+        return 0;
+    }
+    return std::min(n, (HADOKEN_SIMD_ALIGNMENT - misalignment) / sizeof(T));
+}
+
+
+// peeled, blocked and tail loops of the unary kernels, the aliasing
+// guarantees come from the pointers qualification of the caller
+//
+// the pointer types are always explicit: a deduction would drop
+// the restrict qualification of the caller parameters
+template<typename Out, typename InPointer, typename OutPointer, typename UnaryOperation>
+inline void _transform_kernel_loops(InPointer in, OutPointer out, std::size_t n, UnaryOperation & unary_op){
+    const std::size_t block = simd_block_size<Out>::value;
+    const std::size_t peel = _simd_peel_size(out, n);
+
+    std::size_t i = 0;
+    for(; i < peel; ++i){
+        out[i] = unary_op(in[i]);
+    }
+
+    // fixed size blocks: vectorized even by the cheap cost models ( e.g -O2 )
+    for(; i + block <= n; i += block){
+        HADOKEN_PRAGMA_SIMD
+        for(std::size_t j = 0; j < block; ++j){
+            out[i + j] = unary_op(in[i + j]);
+        }
+    }
+
+    for(; i < n; ++i){
+        out[i] = unary_op(in[i]);
+    }
+}
+
+
+// unary kernel on contiguous storage, in and out are either disjoint or equal:
+// the iterations are independent
+template<typename In, typename Out, typename UnaryOperation>
+inline void _transform_kernel(const In* in, Out* out, std::size_t n, UnaryOperation & unary_op){
+    _transform_kernel_loops<Out, const In*, Out*>(in, out, n, unary_op);
+}
+
+
+// unary kernel on disjoint contiguous storage, aliasing free
+template<typename In, typename Out, typename UnaryOperation>
+inline void _transform_kernel_restrict(const In* HADOKEN_RESTRICT in, Out* HADOKEN_RESTRICT out, std::size_t n, UnaryOperation & unary_op){
+    _transform_kernel_loops<Out, const In* HADOKEN_RESTRICT, Out* HADOKEN_RESTRICT>(in, out, n, unary_op);
+}
+
+
+// generic unary slice
+template<typename InputIt, typename OutputIt, typename UnaryOperation>
+inline void _transform_slice(InputIt first, InputIt last, OutputIt d_first, UnaryOperation & unary_op,
+                             std::false_type /* contiguous and unsequenced */){
+    std::transform(first, last, d_first, unary_op);
+}
+
+
+// contiguous unary slice under par_vec, pointer based
+template<typename InputIt, typename OutputIt, typename UnaryOperation>
+inline void _transform_slice(InputIt first, InputIt last, OutputIt d_first, UnaryOperation & unary_op,
+                             std::true_type /* contiguous and unsequenced */){
+    const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+    if(n == 0){
+        return;
+    }
+
+    const auto* in = std::addressof(*first);
+    auto* out = std::addressof(*d_first);
+
+    const std::uintptr_t in_addr = reinterpret_cast<std::uintptr_t>(in);
+    const std::uintptr_t out_addr = reinterpret_cast<std::uintptr_t>(out);
+    const std::uintptr_t in_size = n * sizeof(*in), out_size = n * sizeof(*out);
+
+    if(out_addr + out_size <= in_addr || in_addr + in_size <= out_addr){
+        _transform_kernel_restrict(in, out, n, unary_op);
+    }else if(in_addr == out_addr && in_size == out_size){
+        _transform_kernel(in, out, n, unary_op);
+    }else{
+        std::transform(first, last, d_first, unary_op);
+    }
+}
+
+
+} // detail
+
+
 template< class ExecutionPolicy, class InputIterator1, class InputIterator2, class OutputIterator, class BinaryOperation >
 OutputIterator transform( ExecutionPolicy&& policy, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
                     OutputIterator d_first, BinaryOperation binary_op ){
     if(detail::is_parallel_policy(policy)){
-        InputIterator1 d_last = d_first;
+        OutputIterator d_last = d_first;
 
-        hadoken::parallel::for_range(policy, first1, last1, [&](InputIterator1 local_begin, InputIterator2 local_end){
+        hadoken::parallel::for_range(policy, first1, last1, [&](InputIterator1 local_begin, InputIterator1 local_end){
            const std::size_t pos = std::distance(first1, local_begin);
 
            InputIterator2 local_first2 = first2;
@@ -77,11 +181,26 @@ OutputIterator transform( ExecutionPolicy&& policy, InputIterator1 first1, Input
 template< class ExecutionPolicy, class InputIt, class OutputIt, class UnaryOperation >
 OutputIt transform( ExecutionPolicy&& policy, InputIt first1, InputIt last1, OutputIt d_first,
                     UnaryOperation unary_op ){
-    using value_type = typename std::iterator_traits<InputIt>::value_type;
-    return transform(policy, first1, last1, first1, d_first, [&unary_op](const value_type & v1, const value_type & v2){
-        (void) v2;
-        return unary_op(v1);
-    });
+    typedef typename std::integral_constant<bool,
+            std::is_same<typename std::decay<ExecutionPolicy>::type, parallel_vector_execution_policy>::value
+            && detail::is_contiguous_iterator<InputIt>::value
+            && detail::is_contiguous_iterator<OutputIt>::value> vectorized;
+
+    if(detail::is_parallel_policy(policy)){
+        OutputIt d_last = d_first;
+
+        hadoken::parallel::for_range(policy, first1, last1, [&](InputIt local_begin, InputIt local_end){
+           OutputIt d_local_first = d_first;
+           std::advance(d_local_first, std::distance(first1, local_begin));
+
+           detail::_transform_slice(local_begin, local_end, d_local_first, unary_op, vectorized());
+        });
+
+        std::advance(d_last, std::distance(first1, last1));
+        return d_last;
+    }
+
+    return std::transform(first1, last1, d_first, unary_op);
 }
 
 } //parallel
@@ -39,6 +39,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdexcept>
 #include <sstream>
 #include <algorithm>
+#include <iterator>
 #include <vector>
 
 #include <hadoken/config/platform_config.hpp>
@@ -55,7 +56,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 ///
 ///  counter_engine offers an interface compatible with both C++11 random engine and Boost.Random
 ///
-///  available cbrng backend  are : threefy
+///  available cbrng backend  are : threefy, philox
 ///
 ///
 ///
@@ -76,25 +77,25 @@ public:
     typedef size_t elem_type;
 
     HADOKEN_DECORATE_HOST_DEVICE
-    explicit counter_engine(const key_type &uk) :  b(uk), c(), elem(){}
+    explicit counter_engine(const key_type &uk) :  b(uk), c(), elem(), v(){}
 
     HADOKEN_DECORATE_HOST_DEVICE
-    explicit counter_engine(key_type &uk) : b(uk), c(), elem(){}
+    explicit counter_engine(key_type &uk) : b(uk), c(), elem(), v(){}
 
     HADOKEN_DECORATE_HOST_DEVICE
-    explicit counter_engine() : b(), c(), elem() {
+    explicit counter_engine() : b(), c(), elem(), v() {
 
     }
 
     HADOKEN_DECORATE_HOST_DEVICE
-    explicit counter_engine(result_type r) : b(), c(), elem() {
+    explicit counter_engine(result_type r) : b(), c(), elem(), v() {
         key_type key;
         std::fill(key.begin(), key.end(), typename key_type::value_type(r));
         b.set_key(key);
     }
 
     HADOKEN_DECORATE_HOST_DEVICE
-    explicit counter_engine(std::seed_seq & seq) : b(), c(), elem() {
+    explicit counter_engine(std::seed_seq & seq) : b(), c(), elem(), v() {
         key_type key;
 
         seq.generate(key.begin(), key.end());
@@ -103,9 +104,12 @@ public:
 
 
     HADOKEN_DECORATE_HOST_DEVICE
-    counter_engine(const counter_engine& e) : b(e.b), c(e.c), elem(e.elem){
+    counter_engine(const counter_engine& e) : b(e.b), c(e.c), elem(e.elem), v(e.v){
     }
 
+    HADOKEN_DECORATE_HOST_DEVICE
+    counter_engine& operator=(const counter_engine& e) = default;
+
 
     HADOKEN_DECORATE_HOST_DEVICE
     void seed(result_type r){
@@ -175,6 +179,73 @@ public:
     }
 
 
+    ///
+    /// bulk generation: assign the next values of the stream to [first, last)
+    ///
+    /// equivalent to std::generate(first, last, std::ref(engine)) but
+    /// whole blocks are encrypted by batch ( see threefry::batch ) and written
+    /// directly to the destination, the engine state after the call is the same
+    ///
+    template<typename Iterator>
+    void generate(Iterator first, Iterator last){
+        // drain the values already buffered first
+        while(elem != 0 && first != last){
+            *first = v[--elem];
+            ++first;
+        }
+
+        const std::size_t nelem = c.size();
+        std::uintmax_t remain = std::distance(first, last);
+
+        ctr_type counters[bulk_blocks];
+        ctr_type blocks[bulk_blocks];
+
+        while(remain >= nelem){
+            const std::size_t n_blocks = static_cast<std::size_t>(std::min<std::uintmax_t>(bulk_blocks, remain / nelem));
+
+            if(c[0] <= std::numeric_limits<typename cbrng_type::uint_type>::max() - n_blocks){
+                // no carry propagation in the chunk: only the first counter word moves
+                for(std::size_t i = 0; i < n_blocks; ++i){
+                    counters[i] = c;
+                    counters[i][0] += static_cast<typename cbrng_type::uint_type>(i + 1);
+                }
+                c = counters[n_blocks-1];
+            }else{
+                for(std::size_t i = 0; i < n_blocks; ++i){
+                    incr_array(c.begin(), c.end());
+                    counters[i] = c;
+                }
+            }
+
+            b.batch(counters, n_blocks, blocks);
+
+            // values of a block are delivered from the last one, like operator()
+            for(std::size_t i = 0; i < n_blocks; ++i){
+                for(std::size_t j = nelem; j > 0; --j){
+                    *first = blocks[i][j-1];
+                    ++first;
+                }
+            }
+            remain -= n_blocks * nelem;
+        }
+
+        // partial block: buffered for the next calls
+        while(remain > 0){
+            *first = (*this)();
+            ++first;
+            --remain;
+        }
+    }
+
+
+    ///
+    /// bulk generation: fill the contiguous buffer [data, data + n)
+    ///
+    void fill(result_type* data, std::size_t n){
+        generate(data, data + n);
+    }
+
+
     HADOKEN_DECORATE_HOST_DEVICE
     ctr_type generate_block(){
         elem = 0;
@@ -224,7 +295,10 @@ public:
         std::rotate(derivate_counter.v.begin(), derivate_counter.v.begin()+elem, derivate_counter.v.end());
 
         // and using previous rotate generated block as element
-        key_type new_key= derivate_counter.b(derivate_counter.v);
+        // ( truncated when the key is shorter than a block, e.g philox )
+        const ctr_type new_block = derivate_counter.b(derivate_counter.v);
+        key_type new_key;
+        std::copy(new_block.begin(), new_block.begin() + new_key.size(), new_key.begin());
         // use the new key as counter
         derivate_counter.seed(new_key);
 
@@ -261,6 +335,8 @@ public:
 
 private:
 
+    // number of blocks encrypted together by the bulk generation
+    static constexpr std::size_t bulk_blocks = 64;
 
     template<typename Iterator>
     HADOKEN_DECORATE_HOST_DEVICE
@@ -307,6 +383,9 @@ private:
 
 };
 
+template<typename CBRNG>
+constexpr std::size_t counter_engine<CBRNG>::bulk_blocks;
+
 
 // specialize random_engine_derivate
 // for counter base random generator
@@ -315,6 +394,18 @@ inline counter_engine<CBRNG> random_engine_derivate(const counter_engine<CBRNG>
     return engine.derivate(key);
 }
 
+// counter based engines derivate through their own block cipher,
+// whatever the derivation policy
+template<typename CBRNG>
+inline counter_engine<CBRNG> random_engine_derivate(const counter_engine<CBRNG> & engine, const typename counter_engine<CBRNG>::result_type & key, derivate_sha1_policy ){
+    return engine.derivate(key);
+}
+
+template<typename CBRNG>
+inline counter_engine<CBRNG> random_engine_derivate(const counter_engine<CBRNG> & engine, const typename counter_engine<CBRNG>::result_type & key, derivate_threefry_policy ){
+    return engine.derivate(key);
+}
+
 
 } //_HADOKEN_COUNTER_ENGINE_HPP_
 
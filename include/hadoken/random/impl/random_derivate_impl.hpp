@@ -36,6 +36,7 @@
 #include <cstdint>
 
 #include <hadoken/crypto/sha/sha1.hpp>
+#include <hadoken/random/threefry.hpp>
 
 namespace hadoken {
 
@@ -61,42 +62,100 @@ inline hadoken::sha1::digest32_t generate_deterministic_seed_160(Uint origin_see
 }
 
 
+template<typename Uint>
+inline threefry4x64::range_type generate_deterministic_seed_256(Uint origin_seed, Uint key){
+    static_assert(sizeof(Uint) <= sizeof(std::uint64_t), "derivation supports up to 64 bits seeds");
+
+    // the salt is the cipher key
+    const threefry4x64::key_type salt = { { UINT64_C(0x6c77adb83ef82161), UINT64_C(0xc3d82e4c13fd75d3),
+                                            UINT64_C(0x2b7e151628aed2a6), UINT64_C(0xabf7158809cf4f3c) } };
+
+    //  we want to generate a new seed determinitically 'seed = f(old_seed, key)'
+    //
+    // we do
+    //   new_seed = threefry4x64_salt( key, origin_seed, 0, 0 )
+    //
+    // threefry is a bijection of the counter for a given key, distinct
+    // (key, origin_seed) pairs always produce distinct blocks, and 20 rounds
+    // of threefry4x64 are crush-resistant: no statistical correlation on the output
+    const threefry4x64::domain_type counter = { { std::uint64_t(key), std::uint64_t(origin_seed), 0, 0 } };
+
+    threefry4x64 cipher(salt);
+    return cipher(counter);
+}
+
+
+// reseed the engine and advance it by the number of 1 bits
+// of the derivation material to increase the entropy even more
+template<typename Engine, typename Word, std::size_t N>
+inline void seed_from_material(Engine & res, const std::array<Word, N> & material){
+    typename Engine::result_type new_seed;
+    std::memcpy(&new_seed, &(material[0]), sizeof(typename Engine::result_type));
+
+    res.seed(new_seed);
+
+    for(typename std::array<Word, N>::const_iterator it = material.begin();
+        it < material.end(); ++it){
+
+        std::bitset<sizeof(Word) * 8> bits(*it);
+        const std::size_t iteration = bits.count();
+        for(std::size_t i =0; i <iteration; ++i){
+            (void) res();
+        }
+    }
+}
+
 
 } // end imple
 
 
 
 template<typename Engine>
-inline Engine random_engine_derivate(const Engine & engine, const typename Engine::result_type & key ){
+inline Engine random_engine_derivate(const Engine & engine, const typename Engine::result_type & key, derivate_sha1_policy policy ){
+    (void) policy;
     Engine res(engine);
 
     typename Engine::result_type old_val = res();
 
     // compute a new  seed determinitically
     hadoken::sha1::digest32_t digest = impl::generate_deterministic_seed_160<typename Engine::result_type> (old_val, key);
-    typename Engine::result_type new_seed;
-    std::memcpy(&new_seed, &(digest[0]), sizeof(typename Engine::result_type));
 
-    // use it
-    res.seed(new_seed);
-
-    // use the digest to increase entropy even more
+    // use it, the digest is used to increase entropy even more
     // we get the number of 1 bits in our digest and
     // initialize our random engine from 0 to n
-    for(hadoken::sha1::digest32_t::iterator it = digest.begin();
-        it < digest.end(); ++it){
+    impl::seed_from_material(res, digest);
 
-        std::bitset<32> bits(*it);
-        const std::size_t iteration = bits.count();
-        for(std::size_t i =0; i <iteration; ++i){
-            (void) res();
-        }
-    }
+    return res;
+}
+
+
+template<typename Engine>
+inline Engine random_engine_derivate(const Engine & engine, const typename Engine::result_type & key, derivate_threefry_policy policy ){
+    (void) policy;
+    Engine res(engine);
+
+    typename Engine::result_type old_val = res();
+
+    // compute a new  seed determinitically
+    const threefry4x64::range_type block = impl::generate_deterministic_seed_256<typename Engine::result_type> (old_val, key);
+
+    // same post processing than the SHA-1 digest, on the 160 first bits
+    // of the block seen as 32 bits words
+    std::array<std::uint32_t, 5> material;
+    std::memcpy(&(material[0]), &(block[0]), sizeof(material));
+
+    impl::seed_from_material(res, material);
 
     return res;
 }
 
 
+template<typename Engine>
+inline Engine random_engine_derivate(const Engine & engine, const typename Engine::result_type & key ){
+    return random_engine_derivate(engine, key, derivate_sha1_policy());
+}
+
+
 
 } // end hadoken
 
@@ -4,16 +4,35 @@
 
 
 
+#include <algorithm>
 #include <cassert>
+#include <type_traits>
 
 #include <hadoken/random/random_engine_mapper.hpp>
 #include <hadoken/random/random_derivate.hpp>
+#include <hadoken/random/counter_engine.hpp>
 
 namespace hadoken {
 
 namespace impl{
 
 
+// fill a buffer with the next values of an engine
+// the loop calls the concrete engine directly, no virtual dispatch
+template< typename Uint, typename Engine >
+inline void engine_generate_n(Engine & e, Uint* out, std::size_t n){
+    for(std::size_t i = 0; i < n; ++i){
+        out[i] = e();
+    }
+}
+
+// counter based engines have a vectorized bulk path
+template< typename CBRNG >
+inline void engine_generate_n(counter_engine<CBRNG> & e, typename counter_engine<CBRNG>::result_type* out, std::size_t n){
+    e.fill(out, n);
+}
+
+
 
 template< typename Uint >
 class abstract_engine {
@@ -29,93 +48,196 @@ public:
 
     virtual result_type generate() =0;
 
+    virtual void generate_n(result_type* out, std::size_t n) =0;
+
     virtual abstract_engine* clone() =0;
 
-    virtual abstract_engine* derivate(result_type key) const =0;
+    // derivate from the engine state after consumed values of the last generate_n block
+    virtual abstract_engine* derivate(result_type key, std::size_t consumed, derivate_sha1_policy policy) const =0;
+
+    virtual abstract_engine* derivate(result_type key, std::size_t consumed, derivate_threefry_policy policy) const =0;
 
 private:
 };
 
 
-template< typename Uint, typename Engine >
+// an engine is buffered by the mapper when a copy of its state
+// is not larger than the block of values it generates
+template< typename Engine, std::size_t BlockBytes >
+struct engine_block_buffered : public std::integral_constant<bool, (sizeof(Engine) <= BlockBytes)> {};
+
+
+// state of the engine at the start of the last generate_n block,
+// the derivations start from the values consumed, not from the values generated
+template< typename Engine, bool Buffered >
+struct engine_block_origin{
+    engine_block_origin(const Engine & e) : origin(e), generated(0){}
+
+    inline void reset(const Engine & e){
+        origin = e;
+        generated = 0;
+    }
+
+    inline void save(const Engine & e, std::size_t n){
+        origin = e;
+        generated = n;
+    }
+
+    inline Engine derivation_base(const Engine & current, std::size_t consumed) const{
+        (void) current;
+        Engine res(origin);
+        res.discard(std::min(consumed, generated));
+        return res;
+    }
+
+    Engine origin;
+    std::size_t generated;
+};
+
+// unbuffered engines are never ahead of the values handed out
+template< typename Engine >
+struct engine_block_origin<Engine, false>{
+    engine_block_origin(const Engine &){}
+
+    inline void reset(const Engine &){}
+
+    inline void save(const Engine &, std::size_t){}
+
+    inline Engine derivation_base(const Engine & current, std::size_t) const{
+        return current;
+    }
+};
+
+
+template< typename Uint, typename Engine, bool Buffered >
 class map_engine_intern: public abstract_engine<Uint>{
 public:
     typedef Uint result_type;
 
-    map_engine_intern(const Engine & e) : _e(e){
+    map_engine_intern(const Engine & e) : _e(e), _origin(e){
     }
 
     virtual void map_seed(){
         _e.seed();
+        _origin.reset(_e);
     }
 
     virtual void map_seed(result_type s){
         _e.seed(s);
+        _origin.reset(_e);
     }
 
     virtual result_type generate(){
         return _e();
     }
 
+    virtual void generate_n(result_type* out, std::size_t n){
+        _origin.save(_e, n);
+        engine_generate_n(_e, out, n);
+    }
+
     virtual abstract_engine<result_type>* clone(){
-           return new map_engine_intern(_e);
+           return new map_engine_intern(*this);
+    }
+
+    virtual abstract_engine<result_type>* derivate(result_type key, std::size_t consumed, derivate_sha1_policy policy) const{
+        return derivate_policy(key, consumed, policy);
     }
 
-    virtual abstract_engine<result_type>* derivate(result_type key) const{
-        Engine derivated_engine = random_engine_derivate(_e, key);
-        map_engine_intern<result_type, Engine>* ret = new map_engine_intern<result_type, Engine>(derivated_engine);
-        return ret;
+    virtual abstract_engine<result_type>* derivate(result_type key, std::size_t consumed, derivate_threefry_policy policy) const{
+        return derivate_policy(key, consumed, policy);
     }
 
 private:
+    template<typename DerivatePolicy>
+    abstract_engine<result_type>* derivate_policy(result_type key, std::size_t consumed, DerivatePolicy policy) const{
+        Engine derivated_engine = random_engine_derivate(_origin.derivation_base(_e, consumed), key, policy);
+        return new map_engine_intern(derivated_engine);
+    }
+
     Engine _e;
+    engine_block_origin<Engine, Buffered> _origin;
 };
 
 
 } // impl
 
+template< typename Uint >
+constexpr std::size_t random_engine_mapper<Uint>::buffer_size;
+
+
 template< typename Uint >
 template< typename Engine >
-random_engine_mapper<Uint>::random_engine_mapper(const Engine & e) : _engine(new impl::map_engine_intern<Uint, Engine>(e)){
+random_engine_mapper<Uint>::random_engine_mapper(const Engine & e) :
+    _engine(new impl::map_engine_intern<Uint, Engine, impl::engine_block_buffered<Engine, buffer_size * sizeof(Uint)>::value>(e)),
+    _pos(buffer_size),
+    _buffered(impl::engine_block_buffered<Engine, buffer_size * sizeof(Uint)>::value){
 
 }
 
 
 template< typename Uint >
-random_engine_mapper<Uint>::random_engine_mapper() : _engine() {
+random_engine_mapper<Uint>::random_engine_mapper() : _engine(), _pos(buffer_size), _buffered(false) {
 
 }
 
 template< typename Uint >
-random_engine_mapper<Uint>::random_engine_mapper(const random_engine_mapper<Uint> & other) : _engine(NULL){
+random_engine_mapper<Uint>::random_engine_mapper(const random_engine_mapper<Uint> & other) : _engine(NULL), _pos(other._pos), _buffered(other._buffered){
     if(other._engine.get() != NULL){
         _engine.reset(other._engine->clone());
     }
+    std::copy(other._buffer + _pos, other._buffer + buffer_size, _buffer + _pos);
 }
 
 template< typename Uint >
 void random_engine_mapper<Uint>::seed(){
     assert(_engine.get());
     _engine->map_seed();
+    _pos = buffer_size;
 }
 
 template< typename Uint >
 void random_engine_mapper<Uint>::seed(result_type seed){
     assert(_engine.get());
     _engine->map_seed(seed);
+    _pos = buffer_size;
 }
 
 template< typename Uint >
 typename random_engine_mapper<Uint>::result_type random_engine_mapper<Uint>::operator ()(){
+    if(_pos == buffer_size){
+        if(_buffered == false){
+            assert(_engine.get());
+            return _engine->generate();
+        }
+        refill();
+    }
+    return _buffer[_pos++];
+}
+
+template< typename Uint >
+void random_engine_mapper<Uint>::refill(){
     assert(_engine.get());
-    return _engine->generate();
+    _engine->generate_n(_buffer, buffer_size);
+    _pos = 0;
 }
 
 template< typename Uint >
 random_engine_mapper<Uint> random_engine_mapper<Uint>::derivate(result_type key) const{
+    return derivate(key, derivate_sha1_policy());
+}
+
+template< typename Uint >
+template< typename DerivatePolicy >
+random_engine_mapper<Uint> random_engine_mapper<Uint>::derivate(result_type key, DerivatePolicy policy) const{
     assert(_engine.get());
     random_engine_mapper res;
-    res._engine.reset(_engine->derivate(key));
+
+    // the engine runs ahead of the values handed out when a block is buffered:
+    // derivate from the state of the engine after the values consumed,
+    // as a derivation of the mapped engine itself would do
+    res._engine.reset(_engine->derivate(key, _pos, policy));
+    res._buffered = _buffered;
 
     return res;
 }
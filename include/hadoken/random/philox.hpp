@@ -0,0 +1,413 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+
+
+//
+// This work is derivated from the boost.Random123
+// repository accessible here https://github.com/DEShawResearch/Random123-Boost
+//
+//
+
+#ifndef _HADOKEN_RANDOM_PHILOX_
+#define _HADOKEN_RANDOM_PHILOX_
+
+
+#include <cstdint>
+#include <limits>
+
+
+#include <hadoken/config/platform_config.hpp>
+
+#ifdef HADOKEN_COMPILER_IS_NVCC
+#   include <hadoken/gpu/algorithm.hpp>
+#   include <hadoken/gpu/array.hpp>
+#else
+#   include <algorithm>
+#   include <array>
+
+#endif
+
+///
+///  philox is a state-less counter base random generator
+///  built on integer multiplications, a weakened and specialized
+///  form of a Feistel network
+///
+///   philox has been presented at SC11 in the publication
+///
+/// "Parallel random numbers: as easy as 1, 2, 3".
+///    John K. Salmon, Mark A. Moraes, Ron O. Dror, David E. Shaw" (doi:10.1145/2063384.2063405)
+///
+///  This implementation is freely inspired of Boost.Random123  (https://github.com/DEShawResearch/Random123-Boost )
+///
+
+namespace hadoken{
+
+
+
+namespace utils{
+#ifdef  HADOKEN_COMPILER_IS_NVCC
+    using namespace gpu;
+#else
+    using namespace std;
+#endif
+};
+
+
+namespace impl {
+
+// philox_constants is specialized with the multipliers
+// and the Weyl sequence constants used for the key schedule
+//  philox_constants<2, uint32_t>
+//  philox_constants<2, uint64_t>
+//  philox_constants<4, uint32_t>
+//  philox_constants<4, uint64_t>
+// The constants here are from Salmon et al.
+template <unsigned _N, typename Uint>
+struct philox_constants{
+};
+
+// 2x32 constants
+template <>
+struct philox_constants<2, uint32_t>{
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    static constexpr uint32_t multiplier0(){
+        return UINT32_C(0xD256D193);
+    }
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    static constexpr uint32_t weyl0(){
+        return UINT32_C(0x9E3779B9);
+    }
+};
+
+
+// 4x32 constants
+template <>
+struct philox_constants<4, uint32_t>{
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    static constexpr uint32_t multiplier0(){
+        return UINT32_C(0xD2511F53);
+    }
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    static constexpr uint32_t multiplier1(){
+        return UINT32_C(0xCD9E8D57);
+    }
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    static constexpr uint32_t weyl0(){
+        return UINT32_C(0x9E3779B9);
+    }
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    static constexpr uint32_t weyl1(){
+        return UINT32_C(0xBB67AE85);
+    }
+};
+
+
+// 2x64 constants
+template <>
+struct philox_constants<2, uint64_t>{
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    static constexpr uint64_t multiplier0(){
+        return UINT64_C(0xD2B74407B1CE6E93);
+    }
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    static constexpr uint64_t weyl0(){
+        return UINT64_C(0x9E3779B97F4A7C15);
+    }
+};
+
+
+// 4x64 constants
+template <>
+struct philox_constants<4, uint64_t>{
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    static constexpr uint64_t multiplier0(){
+        return UINT64_C(0xD2E7470EE14C6C93);
+    }
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    static constexpr uint64_t multiplier1(){
+        return UINT64_C(0xCA5A826395121157);
+    }
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    static constexpr uint64_t weyl0(){
+        return UINT64_C(0x9E3779B97F4A7C15);
+    }
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    static constexpr uint64_t weyl1(){
+        return UINT64_C(0xBB67AE8584CAA73B);
+    }
+};
+
+
+
+/// full product of two words: returns the low half, high half in hi
+HADOKEN_DECORATE_HOST_DEVICE
+inline uint32_t philox_mulhilo(uint32_t a, uint32_t b, uint32_t & hi){
+    const uint64_t product = uint64_t(a) * uint64_t(b);
+    hi = uint32_t(product >> 32);
+    return uint32_t(product);
+}
+
+HADOKEN_DECORATE_HOST_DEVICE
+inline uint64_t philox_mulhilo(uint64_t a, uint64_t b, uint64_t & hi){
+#if (defined HADOKEN_COMPILER_IS_NVCC) && (defined __CUDA_ARCH__)
+    hi = __umul64hi(a, b);
+    return a * b;
+#elif (defined __SIZEOF_INT128__)
+    const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    hi = uint64_t(product >> 64);
+    return uint64_t(product);
+#else
+    // portable version, schoolbook multiplication on half words
+    const uint64_t mask = UINT64_C(0xFFFFFFFF);
+    const uint64_t a_lo = a & mask, a_hi = a >> 32;
+    const uint64_t b_lo = b & mask, b_hi = b >> 32;
+
+    const uint64_t lo_lo = a_lo * b_lo;
+    const uint64_t hi_lo = a_hi * b_lo;
+    const uint64_t lo_hi = a_lo * b_hi;
+    const uint64_t hi_hi = a_hi * b_hi;
+
+    const uint64_t cross = (lo_lo >> 32) + (hi_lo & mask) + lo_hi;
+    hi = hi_hi + (hi_lo >> 32) + (cross >> 32);
+    return (cross << 32) | (lo_lo & mask);
+#endif
+}
+
+
+
+/// the number of rounds is known at compile time,
+/// rounds are unrolled by recursive template specialization
+/// like for threefry ( see rounds_functor )
+template <std::size_t r_remain,
+          typename Uint, typename Domain, typename Key, typename Constants, std::size_t N>
+struct philox_rounds_functor{
+    static_assert( N==2 || N==4, "number of words should be 2 or 4");
+};
+
+template <std::size_t r_remain,
+          typename Uint, typename Domain, typename Key, typename Constants>
+struct philox_rounds_functor<r_remain, Uint, Domain, Key, Constants, 4>{
+    typedef Uint uint_type;
+    typedef Domain domain_type;
+    typedef Key key_type;
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    inline void operator() (key_type k, domain_type & c){
+        uint_type hi0, hi1;
+        const uint_type lo0 = philox_mulhilo(Constants::multiplier0(), c[0], hi0);
+        const uint_type lo1 = philox_mulhilo(Constants::multiplier1(), c[2], hi1);
+
+        const uint_type c1 = c[1], c3 = c[3];
+        c[0] = hi1 ^ c1 ^ k[0];
+        c[1] = lo1;
+        c[2] = hi0 ^ c3 ^ k[1];
+        c[3] = lo0;
+
+        // key schedule: Weyl sequence
+        k[0] += Constants::weyl0();
+        k[1] += Constants::weyl1();
+
+        philox_rounds_functor<r_remain-1, uint_type, domain_type, key_type, Constants, 4> func;
+        func(k, c);
+    }
+};
+
+template <typename Uint, typename Domain, typename Key, typename Constants>
+struct philox_rounds_functor<0, Uint, Domain, Key, Constants, 4>{
+    typedef Domain domain_type;
+    typedef Key key_type;
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    inline void operator() (key_type k, domain_type & c){
+        (void) k;
+        (void) c;
+    }
+};
+
+
+template <std::size_t r_remain,
+          typename Uint, typename Domain, typename Key, typename Constants>
+struct philox_rounds_functor<r_remain, Uint, Domain, Key, Constants, 2>{
+    typedef Uint uint_type;
+    typedef Domain domain_type;
+    typedef Key key_type;
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    inline void operator() (key_type k, domain_type & c){
+        uint_type hi;
+        const uint_type lo = philox_mulhilo(Constants::multiplier0(), c[0], hi);
+
+        c[0] = hi ^ k[0] ^ c[1];
+        c[1] = lo;
+
+        // key schedule: Weyl sequence
+        k[0] += Constants::weyl0();
+
+        philox_rounds_functor<r_remain-1, uint_type, domain_type, key_type, Constants, 2> func;
+        func(k, c);
+    }
+};
+
+template <typename Uint, typename Domain, typename Key, typename Constants>
+struct philox_rounds_functor<0, Uint, Domain, Key, Constants, 2>{
+    typedef Domain domain_type;
+    typedef Key key_type;
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    inline void operator() (key_type k, domain_type & c){
+        (void) k;
+        (void) c;
+    }
+};
+
+
+/// default number of blocks processed together by the batch API:
+/// enough to fill a 512 bits register per block word
+template <typename Uint>
+struct philox_batch_lanes{
+    static constexpr std::size_t value = 64 / sizeof(Uint);
+};
+
+
+} // impl
+
+
+template <unsigned N, typename Uint, unsigned R=10, typename Constants=impl::philox_constants<N, Uint> >
+class philox{
+    static_assert( N==2 || N==4, "number of words should be 2 or 4");
+public:
+    typedef utils::array<Uint, N> domain_type;
+    typedef utils::array<Uint, N> range_type;
+    typedef utils::array<Uint, N/2> key_type;
+    typedef Uint                  uint_type;
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    philox() : k(){}
+    HADOKEN_DECORATE_HOST_DEVICE
+    philox(key_type _k) : k(_k) {}
+    HADOKEN_DECORATE_HOST_DEVICE
+    philox(const philox& v) : k(v.k){}
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    void set_key(key_type _k){
+        k = _k;
+    }
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    key_type get_key() const{
+        return k;
+    }
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    bool operator==(const philox& rhs) const{
+        return k == rhs.k;
+    }
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    bool operator!=(const philox& rhs) const{
+        return k != rhs.k;
+    }
+
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    inline range_type operator()(const domain_type & counter){
+        using namespace impl;
+        domain_type c(counter);
+
+        philox_rounds_functor<R, uint_type, domain_type, key_type, Constants, N> func;
+        func(k, c);
+
+        return c;
+    }
+
+
+    ///
+    /// batch encryption of n independent counters
+    ///   out[i] = (*this)(counters[i])  for i in [0, n)
+    ///
+    /// same contract than threefry::batch: groups of Lanes blocks are
+    /// mapped on SIMD lanes by the compiler, bit-identical to operator()
+    ///
+    template<std::size_t Lanes = impl::philox_batch_lanes<Uint>::value>
+    HADOKEN_DECORATE_HOST_DEVICE
+    inline void batch(const domain_type* counters, std::size_t n, range_type* out){
+        using namespace impl;
+        static_assert(Lanes > 0, "batch requires at least one lane");
+
+        // local copy: out may alias the key storage from the compiler point of view
+        const key_type key(k);
+        std::size_t i = 0;
+
+        for(; i + Lanes <= n; i += Lanes){
+            for(std::size_t l = 0; l < Lanes; ++l){
+                domain_type c(counters[i+l]);
+
+                philox_rounds_functor<R, uint_type, domain_type, key_type, Constants, N> func;
+                func(key, c);
+
+                out[i+l] = c;
+            }
+        }
+
+        for(; i < n; ++i){
+            out[i] = (*this)(counters[i]);
+        }
+    }
+
+
+private:
+
+    key_type k;
+};
+
+
+
+typedef philox<4, std::uint64_t> philox4x64;
+typedef philox<2, std::uint64_t> philox2x64;
+
+
+typedef philox<4, std::uint32_t> philox4x32;
+typedef philox<2, std::uint32_t> philox2x32;
+
+
+}
+
+#endif // _HADOKEN_RANDOM_PHILOX_
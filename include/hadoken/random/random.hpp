@@ -34,6 +34,7 @@
 
 #include <hadoken/random/counter_engine.hpp>
 #include <hadoken/random/threefry.hpp>
+#include <hadoken/random/philox.hpp>
 #include <hadoken/random/random_derivate.hpp>
 #include <hadoken/random/random_engine_mapper.hpp>
 
@@ -33,9 +33,35 @@
 
 namespace hadoken {
 
+
+/// derivation policy: seed derivated from a SHA-1 digest
+/// default policy, compatible with the previous versions
+struct derivate_sha1_policy{};
+
+/// derivation policy: seed derivated from one threefry4x64 block encryption
+/// of (key, engine output) under a fixed salt key.
+/// orders of magnitude cheaper than SHA-1, meant for the derivation
+/// of a large number of streams, but gives different streams than derivate_sha1_policy
+struct derivate_threefry_policy{};
+
+
+///
+/// derivate a new random engine from engine and key
+///
+///  - The operation is always deterministic for a given key and engine state
+///  - The new random engine do not have statistical correlation with the old one
+///  - Two different keys, even close in range guarantee two independent random streams
+///
 template<typename Engine>
 inline Engine random_engine_derivate(const Engine & engine, const typename Engine::result_type & key );
 
+/// random_engine_derivate with a selected derivation policy
+template<typename Engine>
+inline Engine random_engine_derivate(const Engine & engine, const typename Engine::result_type & key, derivate_sha1_policy policy );
+
+template<typename Engine>
+inline Engine random_engine_derivate(const Engine & engine, const typename Engine::result_type & key, derivate_threefry_policy policy );
+
 
 }
 
@@ -39,6 +39,8 @@
 #include <boost/integer.hpp>
 #include <boost/scoped_ptr.hpp>
 
+#include <hadoken/random/random_derivate.hpp>
+
 namespace hadoken {
 
 // internals
@@ -54,6 +56,10 @@ template< typename Uint > class abstract_engine;
 /// Allow to abstract different random generators behind a single
 /// interface at runtime
 ///
+/// engines with a small state are pulled by blocks of buffer_size
+/// and handed out from an internal buffer: the virtual dispatch cost
+/// is amortized over a block. Engines with a large state
+/// ( e.g mt19937 ) are called directly.
 ///
 template< typename Uint >
 class random_engine_mapper {
@@ -96,6 +102,11 @@ public:
     ///
     inline random_engine_mapper derivate(result_type key) const;
 
+    /// derivate with a selected derivation policy
+    /// ( derivate_sha1_policy, derivate_threefry_policy )
+    template<typename DerivatePolicy>
+    inline random_engine_mapper derivate(result_type key, DerivatePolicy policy) const;
+
     /// minimum value returned by engine
     /// map to minimum value of the type
     static inline result_type min(){
@@ -108,8 +119,15 @@ public:
         return std::numeric_limits<result_type>::max();
     }
     
-private:    
+private:
+    static constexpr std::size_t buffer_size = 64;
+
+    void refill();
+
     boost::scoped_ptr< impl::abstract_engine<result_type> > _engine;
+    std::size_t _pos;
+    bool _buffered;
+    result_type _buffer[buffer_size];
 };
 
 
@@ -127,6 +145,16 @@ inline random_engine_mapper<Uint> random_engine_derivate(const random_engine_map
     return engine.derivate(key);
 }
 
+template <typename Uint>
+inline random_engine_mapper<Uint> random_engine_derivate(const random_engine_mapper<Uint> & engine, const typename random_engine_mapper<Uint>::result_type & key, derivate_sha1_policy policy ){
+    return engine.derivate(key, policy);
+}
+
+template <typename Uint>
+inline random_engine_mapper<Uint> random_engine_derivate(const random_engine_mapper<Uint> & engine, const typename random_engine_mapper<Uint>::result_type & key, derivate_threefry_policy policy ){
+    return engine.derivate(key, policy);
+}
+
 
 }
 
@@ -38,6 +38,7 @@
 #define _HADOKEN_RANDOM_THREEFRY_
 
 
+#include <limits>
 #include <numeric>
 #include <cstdint>
 #include <random>
@@ -45,6 +46,16 @@
 
 #include <hadoken/config/platform_config.hpp>
 
+// the batch API selects an AVX2 version at runtime on x86
+#if (defined __GNUC__ || defined __clang__) && !(defined HADOKEN_COMPILER_IS_NVCC)
+#   define HADOKEN_THREEFRY_FORCE_INLINE inline __attribute__((always_inline))
+#   if (defined __x86_64__ || defined __i386__)
+#       define HADOKEN_THREEFRY_AVX2_BACKEND 1
+#   endif
+#else
+#   define HADOKEN_THREEFRY_FORCE_INLINE inline
+#endif
+
 #ifdef HADOKEN_COMPILER_IS_NVCC
 #   include <hadoken/gpu/algorithm.hpp>
 #   include <hadoken/gpu/array.hpp>
@@ -213,7 +224,7 @@ struct rounds_functor<r_remain, r_max, Uint, Domain, Constants, 4>{
     typedef Domain domain_type;
 
     HADOKEN_DECORATE_HOST_DEVICE
-    inline void operator() (const utils::array<uint_type, 5> & ks,
+    HADOKEN_THREEFRY_FORCE_INLINE void operator() (const utils::array<uint_type, 5> & ks,
                         domain_type & c){
         constexpr std::size_t r = r_max - r_remain;
 
@@ -255,7 +266,7 @@ struct rounds_functor<0, r_max, Uint, Domain, Constants, 4>{
     typedef Domain domain_type;
 
     HADOKEN_DECORATE_HOST_DEVICE
-    inline void operator() (const utils::array<uint_type, 5> & ks,
+    HADOKEN_THREEFRY_FORCE_INLINE void operator() (const utils::array<uint_type, 5> & ks,
                         domain_type & c){
         (void) ks;
         (void) c;
@@ -271,7 +282,7 @@ struct rounds_functor<r_remain, r_max, Uint, Domain, Constants, 2>{
     typedef Domain domain_type;
 
     HADOKEN_DECORATE_HOST_DEVICE
-    inline void operator() (const utils::array<uint_type, 3> & ks,
+    HADOKEN_THREEFRY_FORCE_INLINE void operator() (const utils::array<uint_type, 3> & ks,
                         domain_type & c){
         constexpr std::size_t r = r_max - r_remain;
 
@@ -304,7 +315,7 @@ struct rounds_functor<0, r_max, Uint, Domain, Constants, 2>{
     typedef Domain domain_type;
 
     HADOKEN_DECORATE_HOST_DEVICE
-    inline void operator() (const utils::array<uint_type, 3> & ks,
+    HADOKEN_THREEFRY_FORCE_INLINE void operator() (const utils::array<uint_type, 3> & ks,
                         domain_type & c){
         (void) ks;
         (void) c;
@@ -312,6 +323,138 @@ struct rounds_functor<0, r_max, Uint, Domain, Constants, 2>{
 
 };
 
+
+/// default number of blocks processed together by the batch API:
+/// enough to fill a 512 bits register per block word
+template <typename Uint>
+struct threefry_batch_lanes{
+    static constexpr std::size_t value = 64 / sizeof(Uint);
+};
+
+
+///
+/// one block word of Lanes independent blocks ( structure of arrays )
+///
+/// the element-wise operations are loops of fixed trip count, vectorized
+/// by the compiler: the rounds_functor applied on a domain of threefry_lanes
+/// runs the rounds of Lanes blocks at once
+///
+template <typename Uint, std::size_t Lanes>
+struct threefry_lanes{
+    Uint v[Lanes];
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    HADOKEN_THREEFRY_FORCE_INLINE threefry_lanes & operator+=(const threefry_lanes & other){
+        for(std::size_t l = 0; l < Lanes; ++l){
+            v[l] += other.v[l];
+        }
+        return *this;
+    }
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    HADOKEN_THREEFRY_FORCE_INLINE threefry_lanes & operator+=(Uint scalar){
+        for(std::size_t l = 0; l < Lanes; ++l){
+            v[l] += scalar;
+        }
+        return *this;
+    }
+
+    HADOKEN_DECORATE_HOST_DEVICE
+    HADOKEN_THREEFRY_FORCE_INLINE threefry_lanes & operator^=(const threefry_lanes & other){
+        for(std::size_t l = 0; l < Lanes; ++l){
+            v[l] ^= other.v[l];
+        }
+        return *this;
+    }
+};
+
+template <typename Uint, std::size_t Lanes>
+HADOKEN_DECORATE_HOST_DEVICE
+HADOKEN_THREEFRY_FORCE_INLINE threefry_lanes<Uint, Lanes> operator^(threefry_lanes<Uint, Lanes> x, const threefry_lanes<Uint, Lanes> & y){
+    x ^= y;
+    return x;
+}
+
+template <typename Uint, std::size_t Lanes>
+HADOKEN_DECORATE_HOST_DEVICE
+HADOKEN_THREEFRY_FORCE_INLINE threefry_lanes<Uint, Lanes> threefry_rotl(const threefry_lanes<Uint, Lanes> & x, unsigned s){
+    threefry_lanes<Uint, Lanes> res;
+    for(std::size_t l = 0; l < Lanes; ++l){
+        res.v[l] = (x.v[l] << s) | (x.v[l] >> (std::numeric_limits<Uint>::digits - s));
+    }
+    return res;
+}
+
+
+/// encryption of n_groups groups of Lanes counters, the words of
+/// each group are transposed in threefry_lanes, encrypted, transposed back
+template <std::size_t Lanes, unsigned R, typename Constants, std::size_t N, typename Uint>
+HADOKEN_DECORATE_HOST_DEVICE
+HADOKEN_THREEFRY_FORCE_INLINE void threefry_batch_body(const utils::array<Uint, N> & key, const utils::array<Uint, N+1> & ks,
+                                                      const utils::array<Uint, N>* counters, std::size_t n_groups,
+                                                      utils::array<Uint, N>* out){
+    typedef utils::array<threefry_lanes<Uint, Lanes>, N> lanes_domain;
+
+    for(std::size_t g = 0; g < n_groups; ++g){
+        const utils::array<Uint, N>* group_counters = counters + g * Lanes;
+        utils::array<Uint, N>* group_out = out + g * Lanes;
+
+        lanes_domain c;
+        for(std::size_t w = 0; w < N; ++w){
+            for(std::size_t l = 0; l < Lanes; ++l){
+                c[w].v[l] = group_counters[l][w] + key[w];
+            }
+        }
+
+        rounds_functor<R, R, Uint, lanes_domain, Constants, N> func;
+        func(ks, c);
+
+        for(std::size_t w = 0; w < N; ++w){
+            for(std::size_t l = 0; l < Lanes; ++l){
+                group_out[l][w] = c[w].v[l];
+            }
+        }
+    }
+}
+
+
+/// block by block encryption: without AVX2 the transposed words of a group
+/// do not fit in the SIMD registers and the lanes run slower than the scalar rounds
+template <std::size_t Lanes, unsigned R, typename Constants, std::size_t N, typename Uint>
+HADOKEN_DECORATE_HOST_DEVICE
+inline void threefry_batch_default(const utils::array<Uint, N> & key, const utils::array<Uint, N+1> & ks,
+                                   const utils::array<Uint, N>* counters, std::size_t n_groups, utils::array<Uint, N>* out){
+    for(std::size_t i = 0; i < n_groups * Lanes; ++i){
+        utils::array<Uint, N> c;
+        for(std::size_t w = 0; w < N; ++w){
+            c[w] = counters[i][w] + key[w];
+        }
+
+        rounds_functor<R, R, Uint, utils::array<Uint, N>, Constants, N> func;
+        func(ks, c);
+
+        out[i] = c;
+    }
+}
+
+
+#ifdef HADOKEN_THREEFRY_AVX2_BACKEND
+
+template <std::size_t Lanes, unsigned R, typename Constants, std::size_t N, typename Uint>
+__attribute__((target("avx2")))
+inline void threefry_batch_avx2(const utils::array<Uint, N> & key, const utils::array<Uint, N+1> & ks,
+                                const utils::array<Uint, N>* counters, std::size_t n_groups, utils::array<Uint, N>* out){
+    threefry_batch_body<Lanes, R, Constants>(key, ks, counters, n_groups, out);
+}
+
+inline bool threefry_cpu_has_avx2(){
+    static const bool has_avx2 = (__builtin_cpu_supports("avx2") != 0);
+    return has_avx2;
+}
+
+#endif // HADOKEN_THREEFRY_AVX2_BACKEND
+
+
 } // impl
 
 template <unsigned N, typename Uint, unsigned R=20, typename Constants=impl::threefry_constants<N, Uint> >
@@ -354,11 +497,9 @@ public:
     HADOKEN_DECORATE_HOST_DEVICE
     inline range_type operator()(const domain_type & counter){
         using namespace impl;
-        utils::array<uint_type, N+1>  ks;
+        const utils::array<uint_type, N+1>  ks = key_schedule();
         domain_type c(counter);
 
-        utils::copy(k.begin(), k.end(), ks.begin());
-        ks[N] = utils::accumulate(k.begin(), k.end(), Constants::ks_parity(), utils::bit_xor<uint_type>());
         utils::transform(k.begin(), k.end(), c.begin(), c.begin(), utils::plus<uint_type>());
 
         rounds_functor<R, R, uint_type, domain_type, Constants, N> func;
@@ -368,8 +509,52 @@ public:
     }
 
 
+    ///
+    /// batch encryption of n independent counters
+    ///   out[i] = (*this)(counters[i])  for i in [0, n)
+    ///
+    /// on x86 with AVX2 ( selected at runtime ), counters are processed by groups of Lanes
+    /// blocks: each block word of the group is transposed in an array of Lanes values
+    /// ( structure of arrays ) and the rounds run on the whole array, one SIMD lane per block.
+    /// Otherwise, and for the remainder, the blocks go through the scalar rounds.
+    /// The result is bit-identical to the scalar operator()
+    ///
+    template<std::size_t Lanes = impl::threefry_batch_lanes<Uint>::value>
+    HADOKEN_DECORATE_HOST_DEVICE
+    inline void batch(const domain_type* counters, std::size_t n, range_type* out){
+        using namespace impl;
+        static_assert(Lanes > 0, "batch requires at least one lane");
+
+        // local copies: out may alias the key storage from the compiler point of view
+        const key_type key(k);
+        const utils::array<uint_type, N+1>  ks = key_schedule();
+        const std::size_t n_groups = n / Lanes;
+
+#ifdef HADOKEN_THREEFRY_AVX2_BACKEND
+        if(threefry_cpu_has_avx2()){
+            threefry_batch_avx2<Lanes, R, Constants>(key, ks, counters, n_groups, out);
+        }else
+#endif
+        {
+            threefry_batch_default<Lanes, R, Constants>(key, ks, counters, n_groups, out);
+        }
+
+        for(std::size_t i = n_groups * Lanes; i < n; ++i){
+            out[i] = (*this)(counters[i]);
+        }
+    }
+
+
 private:
 
+    HADOKEN_DECORATE_HOST_DEVICE
+    inline utils::array<uint_type, N+1> key_schedule() const{
+        utils::array<uint_type, N+1>  ks;
+        utils::copy(k.begin(), k.end(), ks.begin());
+        ks[N] = utils::accumulate(k.begin(), k.end(), Constants::ks_parity(), utils::bit_xor<uint_type>());
+        return ks;
+    }
+
     key_type k;
 };
 
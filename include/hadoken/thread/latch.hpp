@@ -33,6 +33,8 @@
 #include <thread>
 #include <assert.h>
 #include <condition_variable>
+#include <mutex>
+#include <chrono>
 
 
 namespace hadoken {
@@ -101,8 +103,12 @@ public:
         // if the lifetime of the latch is the same that one of the waiting thread
         while(_counter.load() > unlocked){
             if(_counter.load() > 0){
+                // the counter is checked again under the lock, the notification
+                // of a count down between the two checks can not be missed
                 std::unique_lock<std::mutex> _l(_latch_lock);
-                _cond.wait_for(_l, std::chrono::milliseconds(1));
+                _cond.wait_for(_l, std::chrono::milliseconds(1), [this]{
+                    return _counter.load() <= 0;
+                });
             }else{
 #ifndef HADOKEN_SPIN_NO_YIELD
                 std::this_thread::yield();
@@ -120,6 +126,9 @@ private:
 
     inline void __check_and_notify(std::ptrdiff_t v){
         if(v <= 0){
+            {
+                std::lock_guard<std::mutex> _l(_latch_lock);
+            }
             _cond.notify_all();
             _counter.store(unlocked);
         }
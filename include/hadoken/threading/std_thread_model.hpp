@@ -48,6 +48,16 @@ public:
 };
 
 
+///
+/// std thread model, selects lock-free bounded containers
+/// when they are available ( e.g concurrent_queue )
+///
+class std_lockfree_thread_model : public std_thread_model{
+public:
+
+};
+
+
 } //hadoken
 
 #endif // STD_THREAD_MODEL_HPP
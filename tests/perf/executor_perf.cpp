@@ -51,6 +51,11 @@ typedef  system_clock::time_point tp;
 typedef  system_clock cl;
 
 
+struct work_stealing_pool_executor : public hadoken::thread_pool_executor{
+    work_stealing_pool_executor() : hadoken::thread_pool_executor(0, hadoken::thread_pool_scheduler::work_stealing) {}
+};
+
+
 template<typename Executor>
 std::size_t executor_test(std::size_t n_exec, const std::string & executor_name){
 
@@ -128,12 +133,16 @@ int main(){
 
     junk += executor_test<hadoken::thread_pool_executor>(n_exec, "pool_executor");
 
+    junk += executor_test<work_stealing_pool_executor>(n_exec, "pool_executor_work_stealing");
+
     junk += executor_test<hadoken::simple_thread_executor>(n_exec, "simple_executor");
 
     junk += executor_test<hadoken::system_executor>(n_exec, "system_executor");
 
     junk += executor_test_twoway<hadoken::thread_pool_executor>(n_exec, "pool_executor_twoway");
 
+    junk += executor_test_twoway<work_stealing_pool_executor>(n_exec, "pool_executor_work_stealing_twoway");
+
     std::cout << "end junk " << junk << std::endl;
 
 }
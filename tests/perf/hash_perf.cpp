@@ -0,0 +1,238 @@
+/**
+ * Copyright (c) 2018, Adrien Devresse <adrien.devresse@epfl.ch>
+ * 
+ * Boost Software License - Version 1.0 
+ * 
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ * 
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+* 
+*/
+
+
+
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+
+#include <boost/chrono.hpp>
+
+#include <hadoken/crypto/crypto.hpp>
+#include <hadoken/crypto/hash_file.hpp>
+
+
+using namespace boost::chrono;
+
+typedef  system_clock::time_point tp;
+typedef  system_clock cl;
+
+
+const std::size_t buffer_size = 64 * 1024 * 1024;
+
+
+std::uint32_t test_sha1_bytewise(const std::vector<std::uint8_t> & data){
+    tp t1, t2;
+
+    t1 = cl::now();
+
+    hadoken::sha1 sha;
+    for(std::uint8_t b : data){
+        sha.process(b);
+    }
+    hadoken::sha1::digest32_t digest = sha.get_digest();
+
+    t2 = cl::now();
+
+    std::cout << "sha1 byte by byte: " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    return digest[0];
+}
+
+
+std::uint32_t test_sha1_block(const std::vector<std::uint8_t> & data){
+    tp t1, t2;
+
+    t1 = cl::now();
+
+    hadoken::sha1 sha;
+    sha.process_block(&data[0], data.size());
+    hadoken::sha1::digest32_t digest = sha.get_digest();
+
+    t2 = cl::now();
+
+    std::cout << "sha1 block: " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    return digest[0];
+}
+
+
+std::uint32_t test_sha1_compress_generic(const std::vector<std::uint8_t> & data){
+    tp t1, t2;
+
+    t1 = cl::now();
+
+    std::uint32_t state[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+    hadoken::impl::sha1_compress_generic(state, &data[0], data.size() / 64);
+
+    t2 = cl::now();
+
+    std::cout << "sha1 generic compress: " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    return state[0];
+}
+
+
+std::uint32_t test_sha1_serial_messages(const std::vector<std::string> & messages){
+    tp t1, t2;
+
+    t1 = cl::now();
+
+    std::uint32_t res = 0;
+    for(const std::string & msg : messages){
+        hadoken::sha1 sha;
+        sha.process_block(msg.data(), msg.size());
+        res += sha.get_digest()[0];
+    }
+
+    t2 = cl::now();
+
+    std::cout << "sha1 " << messages.size() << " messages serial: " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    return res;
+}
+
+
+std::uint32_t test_sha1_multi_messages(const std::vector<std::string> & messages, hadoken::sha1_multi::backend_type backend){
+    tp t1, t2;
+
+    t1 = cl::now();
+
+    hadoken::sha1_multi hasher(backend);
+    std::vector<hadoken::sha1::digest32_t> digests = hasher.hash(messages);
+
+    t2 = cl::now();
+
+    std::cout << "sha1_multi " << messages.size() << " messages ( " << hasher.lanes() << " lanes ): " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    return digests[0][0];
+}
+
+
+std::uint64_t test_fast_hash_block(const std::vector<std::uint8_t> & data){
+    tp t1, t2;
+
+    t1 = cl::now();
+
+    const std::uint64_t h64 = hadoken::crypto::hash64(&data[0], data.size());
+
+    t2 = cl::now();
+
+    std::cout << "hash64 block: " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+
+    t1 = cl::now();
+
+    const hadoken::crypto::hash128_t h128 = hadoken::crypto::hash128(&data[0], data.size());
+
+    t2 = cl::now();
+
+    std::cout << "hash128 block: " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    return h64 + h128[0];
+}
+
+
+std::uint64_t test_fast_hash_keys(const std::vector<std::string> & keys){
+    tp t1, t2;
+
+    t1 = cl::now();
+
+    std::uint64_t res = 0;
+    for(const std::string & key : keys){
+        res += hadoken::crypto::hash64(key);
+    }
+
+    t2 = cl::now();
+
+    std::cout << "hash64 " << keys.size() << " keys: " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    return res;
+}
+
+
+template<typename Function>
+std::uint32_t test_hash_file(const std::string & name, Function fun){
+    tp t1, t2;
+
+    t1 = cl::now();
+
+    hadoken::sha1::digest32_t digest = fun();
+
+    t2 = cl::now();
+
+    std::cout << name << ": " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    return digest[0];
+}
+
+
+
+int main(){
+
+    std::vector<std::uint8_t> data(buffer_size);
+    for(std::size_t i = 0; i < data.size(); ++i){
+        data[i] = static_cast<std::uint8_t>(i * 2654435761u >> 24);
+    }
+
+    std::cout << "hash of " << (buffer_size / (1024 * 1024)) << " MiB" << std::endl;
+
+    std::uint32_t junk = 0;
+    junk += test_sha1_bytewise(data);
+    junk += test_sha1_block(data);
+    junk += test_sha1_compress_generic(data);
+    junk += static_cast<std::uint32_t>(test_fast_hash_block(data));
+
+    for(std::size_t msg_size : { 16, 100, 1000 }){
+        std::vector<std::string> messages(buffer_size / msg_size / 4);
+        for(std::size_t i = 0; i < messages.size(); ++i){
+            messages[i].assign(reinterpret_cast<const char*>(&data[(i * msg_size) % (buffer_size - msg_size)]), msg_size);
+        }
+        junk += test_sha1_serial_messages(messages);
+        junk += static_cast<std::uint32_t>(test_fast_hash_keys(messages));
+        junk += test_sha1_multi_messages(messages, hadoken::sha1_multi::backend_auto);
+        junk += test_sha1_multi_messages(messages, hadoken::sha1_multi::backend_lanes);
+    }
+
+    const std::string path = "/tmp/hadoken_hash_perf_file";
+    {
+        std::ofstream out(path, std::ios::out | std::ios::binary);
+        for(int i = 0; i < 4; ++i){
+            out.write(reinterpret_cast<const char*>(&data[0]), static_cast<std::streamsize>(data.size()));
+        }
+    }
+
+    using namespace hadoken::crypto;
+    junk += test_hash_file("hash_file mmap 256 MiB", [&](){ return hash_file(path, hash_file_method::mmap); });
+    junk += test_hash_file("hash_file read 256 MiB", [&](){ return hash_file(path, hash_file_method::read); });
+    junk += test_hash_file("hash_file_tree seq 256 MiB", [&](){ return hash_file_tree(hadoken::parallel::seq, path); });
+    junk += test_hash_file("hash_file_tree par 256 MiB", [&](){ return hash_file_tree(hadoken::parallel::par, path); });
+
+    std::remove(path.c_str());
+
+    std::cout << "junk " << junk << std::endl;
+
+    return 0;
+}
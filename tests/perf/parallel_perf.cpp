@@ -33,6 +33,8 @@
 #include <future>
 #include <vector>
 #include <set>
+#include <numeric>
+#include <cstdint>
 
 #include <boost/test/floating_point_comparison.hpp>
 
@@ -176,6 +178,283 @@ struct hadoken_parallel_for_each{
 
 
 
+// irregular workload: the cost of an element grows with its position,
+// the last static slice gets most of the work
+template<typename ForEach>
+std::size_t skewed_for_each_vector(std::size_t s_vector, std::size_t n_exec, const std::string & executor_name){
+
+    tp t1, t2;
+
+    std::vector<double> values(s_vector, 0);
+    std::iota(values.begin(), values.end(), 0.0);
+
+    const double s_vector_double = double(s_vector);
+
+    auto fops = [s_vector_double](double & v){
+        const std::size_t n_iter = 1 + std::size_t(64.0 * (v / s_vector_double) * (v / s_vector_double));
+        double res = v;
+        for(std::size_t i = 0; i < n_iter; ++i){
+            res = dummy_operation<double>(res);
+        }
+        v = res;
+    };
+
+    std::size_t cumulated_time =0;
+
+    for(std::size_t i=0; i < n_exec; ++i){
+
+        std::iota(values.begin(), values.end(), 0.0);
+
+        t1 = cl::now();
+
+        ForEach f;
+
+        f.for_each(values.begin(), values.end(), fops);
+
+        t2 = cl::now();
+
+        cumulated_time += boost::chrono::duration_cast<microseconds>(t2 -t1).count();
+    }
+
+    std::cout << "" << executor_name << "; skewed vector;  " << s_vector << "; " << double(cumulated_time)/n_exec << ";" << std::endl;
+
+    return std::size_t(std::accumulate(values.begin(), values.end(), 0.0, std::plus<double>()));
+}
+
+
+
+template<hadoken::parallel::schedule_type Schedule>
+struct hadoken_scheduled_for_each{
+
+    template<typename Iter, typename Fun>
+    void for_each(Iter iter1, Iter iter2, Fun fun){
+        using namespace hadoken;
+        parallel::for_each(parallel::par.with_schedule(Schedule), iter1, iter2, fun);
+    }
+
+};
+
+
+
+template<typename Transform>
+std::size_t transform_vector(std::size_t s_vector, std::size_t n_exec, const std::string & executor_name){
+
+    tp t1, t2;
+
+    std::vector<float> values(s_vector), res(s_vector);
+    std::iota(values.begin(), values.end(), 0.0f);
+
+    std::size_t cumulated_time =0;
+
+    for(std::size_t i=0; i < n_exec; ++i){
+
+        t1 = cl::now();
+
+        Transform f;
+
+        f.transform(values.begin(), values.end(), res.begin(), [](float v){ return v * 2.0f + 1.0f; });
+
+        t2 = cl::now();
+
+        cumulated_time += boost::chrono::duration_cast<microseconds>(t2 -t1).count();
+    }
+
+    std::cout << "" << executor_name << "; vector;  " << s_vector << "; " << double(cumulated_time)/n_exec << ";" << std::endl;
+
+    return std::size_t(res.back());
+}
+
+
+
+struct std_transform{
+
+    template<typename Iter, typename OutIter, typename Fun>
+    void transform(Iter iter1, Iter iter2, OutIter out, Fun fun){
+        std::transform(iter1, iter2, out, fun);
+    }
+
+};
+
+
+
+template<typename Policy>
+struct hadoken_parallel_transform{
+
+    template<typename Iter, typename OutIter, typename Fun>
+    void transform(Iter iter1, Iter iter2, OutIter out, Fun fun){
+        using namespace hadoken;
+        parallel::transform(Policy(), iter1, iter2, out, fun);
+    }
+
+};
+
+
+
+template<typename CopyIf>
+std::size_t copy_if_vector(std::size_t s_vector, std::size_t n_exec, const std::string & executor_name){
+
+    tp t1, t2;
+
+    std::vector<std::uint64_t> values(s_vector), res(s_vector);
+    std::iota(values.begin(), values.end(), 0);
+
+    std::size_t cumulated_time =0, n_selected = 0;
+
+    for(std::size_t i=0; i < n_exec; ++i){
+
+        t1 = cl::now();
+
+        CopyIf f;
+
+        // one element out of three selected
+        n_selected = f.copy_if(values.begin(), values.end(), res.begin(), [](std::uint64_t v){ return (v * 0x9E3779B97F4A7C15ULL) % 3 == 0; });
+
+        t2 = cl::now();
+
+        cumulated_time += boost::chrono::duration_cast<microseconds>(t2 -t1).count();
+    }
+
+    std::cout << "" << executor_name << "; vector;  " << s_vector << "; " << double(cumulated_time)/n_exec << ";" << std::endl;
+
+    return n_selected;
+}
+
+
+
+struct std_copy_if{
+
+    template<typename Iter, typename OutIter, typename Pred>
+    std::size_t copy_if(Iter iter1, Iter iter2, OutIter out, Pred pred){
+        return std::size_t(std::copy_if(iter1, iter2, out, pred) - out);
+    }
+
+};
+
+
+
+struct hadoken_parallel_copy_if{
+
+    template<typename Iter, typename OutIter, typename Pred>
+    std::size_t copy_if(Iter iter1, Iter iter2, OutIter out, Pred pred){
+        using namespace hadoken;
+        return std::size_t(parallel::copy_if(parallel::par, iter1, iter2, out, pred) - out);
+    }
+
+};
+
+
+
+template<typename Sort>
+std::size_t sort_keys_vector(std::size_t s_vector, std::size_t n_exec, const std::string & executor_name){
+
+    tp t1, t2;
+
+    std::vector<std::uint64_t> keys(s_vector), res(s_vector);
+    for(std::size_t i = 0; i < s_vector; ++i){
+        // 32 bits ids in 64 bits keys
+        keys[i] = (i * 0x9E3779B97F4A7C15ULL) >> 32;
+    }
+
+    std::size_t cumulated_time =0;
+
+    for(std::size_t i=0; i < n_exec; ++i){
+
+        std::copy(keys.begin(), keys.end(), res.begin());
+
+        t1 = cl::now();
+
+        Sort f;
+
+        f.sort(res.begin(), res.end());
+
+        t2 = cl::now();
+
+        cumulated_time += boost::chrono::duration_cast<microseconds>(t2 -t1).count();
+    }
+
+    std::cout << "" << executor_name << "; vector;  " << s_vector << "; " << double(cumulated_time)/n_exec << ";" << std::endl;
+
+    return (s_vector > 0) ? std::size_t(res.back()) : 0;
+}
+
+
+
+struct std_sort{
+
+    template<typename Iter>
+    void sort(Iter iter1, Iter iter2){
+        std::sort(iter1, iter2);
+    }
+
+};
+
+
+
+struct hadoken_parallel_radix_sort{
+
+    template<typename Iter>
+    void sort(Iter iter1, Iter iter2){
+        using namespace hadoken;
+        parallel::radix_sort(parallel::par, iter1, iter2);
+    }
+
+};
+
+
+
+template<typename Scan>
+std::size_t scan_vector(std::size_t s_vector, std::size_t n_exec, const std::string & executor_name){
+
+    tp t1, t2;
+
+    std::vector<std::uint64_t> values(s_vector), res(s_vector);
+    std::iota(values.begin(), values.end(), 0);
+
+    std::size_t cumulated_time =0;
+
+    for(std::size_t i=0; i < n_exec; ++i){
+
+        t1 = cl::now();
+
+        Scan f;
+
+        f.scan(values.begin(), values.end(), res.begin());
+
+        t2 = cl::now();
+
+        cumulated_time += boost::chrono::duration_cast<microseconds>(t2 -t1).count();
+    }
+
+    std::cout << "" << executor_name << "; vector;  " << s_vector << "; " << double(cumulated_time)/n_exec << ";" << std::endl;
+
+    return std::size_t(res.back());
+}
+
+
+
+struct std_inclusive_scan{
+
+    template<typename Iter, typename OutIter>
+    void scan(Iter iter1, Iter iter2, OutIter out){
+        std::partial_sum(iter1, iter2, out);
+    }
+
+};
+
+
+
+struct hadoken_parallel_inclusive_scan{
+
+    template<typename Iter, typename OutIter>
+    void scan(Iter iter1, Iter iter2, OutIter out){
+        using namespace hadoken;
+        parallel::inclusive_scan(parallel::parallel_execution_policy(), iter1, iter2, out);
+    }
+
+};
+
+
+
 int main(){
     std::string parallel_mode = "";
 #ifdef HADOKEN_PARALLEL_USE_OMP
@@ -208,6 +487,106 @@ int main(){
     }
 
 
+    hadoken::format::scat(std::cout, "\n# test algorithms for sets with ", n_exec, " iterations \n");
+
+    local_n_exec = n_exec;
+    for(std::size_t i =1; i <= 1000000; i*=10){
+        junk += for_each_set<std_for_each>(i, local_n_exec, fmt::scat(parallel_mode, "; ",ncore, "; ", "serial_for_each"));
+
+        junk += for_each_set<hadoken_parallel_for_each>(i, local_n_exec, fmt::scat(parallel_mode, "; ",ncore,"; ", "parallel_for_each"));
+
+        if( i >= limit_size_iter){
+            local_n_exec /= 10;
+            local_n_exec = std::max<decltype(local_n_exec)>(local_n_exec, 1);
+        }
+    }
+
+
+    hadoken::format::scat(std::cout, "\n# test for_each schedules with skewed workloads \n");
+
+    {
+        using hadoken::parallel::schedule_type;
+        const std::size_t n_exec_skewed = 5;
+
+        for(std::size_t i =1000; i <= 100000; i*=10){
+            junk += skewed_for_each_vector<std_for_each>(i, n_exec_skewed, fmt::scat(parallel_mode, "; ",ncore, "; ", "serial_for_each"));
+
+            junk += skewed_for_each_vector<hadoken_scheduled_for_each<schedule_type::static_split> >(i, n_exec_skewed,
+                                                                fmt::scat(parallel_mode, "; ",ncore,"; ", "parallel_for_each_static"));
+
+            junk += skewed_for_each_vector<hadoken_scheduled_for_each<schedule_type::dynamic> >(i, n_exec_skewed,
+                                                                fmt::scat(parallel_mode, "; ",ncore,"; ", "parallel_for_each_dynamic"));
+
+            junk += skewed_for_each_vector<hadoken_scheduled_for_each<schedule_type::guided> >(i, n_exec_skewed,
+                                                                fmt::scat(parallel_mode, "; ",ncore,"; ", "parallel_for_each_guided"));
+        }
+    }
+
+
+    hadoken::format::scat(std::cout, "\n# test unary transform for vectors with ", n_exec, " iterations \n");
+
+    local_n_exec = n_exec;
+    for(std::size_t i =1; i < max_size_vector; i*=10){
+        junk += transform_vector<std_transform>(i, local_n_exec, fmt::scat(parallel_mode, "; ",ncore, "; ", "serial_transform"));
+
+        junk += transform_vector<hadoken_parallel_transform<hadoken::parallel::parallel_execution_policy> >(i, local_n_exec,
+                                                                fmt::scat(parallel_mode, "; ",ncore,"; ", "parallel_transform"));
+
+        junk += transform_vector<hadoken_parallel_transform<hadoken::parallel::parallel_vector_execution_policy> >(i, local_n_exec,
+                                                                fmt::scat(parallel_mode, "; ",ncore,"; ", "parallel_vector_transform"));
+
+        if( i >= limit_size_iter){
+            local_n_exec /= 10;
+            local_n_exec = std::max<decltype(local_n_exec)>(local_n_exec, 1);
+        }
+    }
+
+
+    hadoken::format::scat(std::cout, "\n# test copy_if for vectors with ", n_exec, " iterations \n");
+
+    local_n_exec = n_exec;
+    for(std::size_t i =1; i < max_size_vector; i*=10){
+        junk += copy_if_vector<std_copy_if>(i, local_n_exec, fmt::scat(parallel_mode, "; ",ncore, "; ", "serial_copy_if"));
+
+        junk += copy_if_vector<hadoken_parallel_copy_if>(i, local_n_exec, fmt::scat(parallel_mode, "; ",ncore,"; ", "parallel_copy_if"));
+
+        if( i >= limit_size_iter){
+            local_n_exec /= 10;
+            local_n_exec = std::max<decltype(local_n_exec)>(local_n_exec, 1);
+        }
+    }
+
+
+    hadoken::format::scat(std::cout, "\n# test radix_sort for vectors with ", n_exec, " iterations \n");
+
+    local_n_exec = n_exec;
+    for(std::size_t i =1; i < max_size_vector; i*=10){
+        junk += sort_keys_vector<std_sort>(i, local_n_exec, fmt::scat(parallel_mode, "; ",ncore, "; ", "serial_sort"));
+
+        junk += sort_keys_vector<hadoken_parallel_radix_sort>(i, local_n_exec, fmt::scat(parallel_mode, "; ",ncore,"; ", "parallel_radix_sort"));
+
+        if( i >= limit_size_iter){
+            local_n_exec /= 10;
+            local_n_exec = std::max<decltype(local_n_exec)>(local_n_exec, 1);
+        }
+    }
+
+
+    hadoken::format::scat(std::cout, "\n# test inclusive_scan for vectors with ", n_exec, " iterations \n");
+
+    local_n_exec = n_exec;
+    for(std::size_t i =1; i < max_size_vector; i*=10){
+        junk += scan_vector<std_inclusive_scan>(i, local_n_exec, fmt::scat(parallel_mode, "; ",ncore, "; ", "serial_inclusive_scan"));
+
+        junk += scan_vector<hadoken_parallel_inclusive_scan>(i, local_n_exec, fmt::scat(parallel_mode, "; ",ncore,"; ", "parallel_inclusive_scan"));
+
+        if( i >= limit_size_iter){
+            local_n_exec /= 10;
+            local_n_exec = std::max<decltype(local_n_exec)>(local_n_exec, 1);
+        }
+    }
+
+
 /*
 
 #ifndef HADOKEN_PARALLEL_USE_OMP
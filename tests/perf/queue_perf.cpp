@@ -0,0 +1,178 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ * 
+ * Boost Software License - Version 1.0 
+ * 
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ * 
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+* 
+*/
+
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <iterator>
+
+#include <boost/chrono.hpp>
+
+#include <hadoken/format/format.hpp>
+
+#include <hadoken/containers/concurrent_queue.hpp>
+
+
+using namespace boost::chrono;
+
+typedef  system_clock::time_point tp;
+typedef  system_clock cl;
+
+
+// n_producers push n_messages each, a single consumer pops them all
+template<typename Queue>
+std::size_t queue_test(std::size_t n_producers, std::size_t n_messages, const std::string & queue_name){
+
+    tp t1, t2;
+
+    std::size_t val=0;
+
+    Queue queue;
+
+    t1 = cl::now();
+
+    std::vector<std::thread> producers;
+    for(std::size_t p = 0; p < n_producers; ++p){
+        producers.emplace_back([&queue, n_messages](){
+            for(std::size_t i = 0; i < n_messages; ++i){
+                queue.push(i);
+            }
+        });
+    }
+
+    std::size_t received = 0;
+    while(received < n_producers * n_messages){
+        auto item = queue.try_pop(std::chrono::milliseconds(1));
+        if(item){
+            val += item.get();
+            received++;
+        }
+    }
+
+    for(auto & t : producers){
+        t.join();
+    }
+
+    t2 = cl::now();
+
+    std::cout << queue_name << "; " << n_producers << "; " << double(boost::chrono::duration_cast<nanoseconds>(t2 -t1).count())/(n_producers * n_messages) << ";" << std::endl;
+
+    return val;
+}
+
+
+// same with batch push_n / try_pop_n
+template<typename Queue>
+std::size_t queue_test_batch(std::size_t n_producers, std::size_t n_messages, std::size_t batch_size, const std::string & queue_name){
+
+    tp t1, t2;
+
+    std::size_t val=0;
+
+    Queue queue;
+
+    t1 = cl::now();
+
+    std::vector<std::thread> producers;
+    for(std::size_t p = 0; p < n_producers; ++p){
+        producers.emplace_back([&queue, n_messages, batch_size](){
+            std::vector<std::size_t> batch(batch_size);
+            for(std::size_t i = 0; i < n_messages; i += batch_size){
+                const std::size_t n = std::min(batch_size, n_messages - i);
+                for(std::size_t j = 0; j < n; ++j){
+                    batch[j] = i + j;
+                }
+                queue.push_n(batch.begin(), n);
+            }
+        });
+    }
+
+    std::vector<std::size_t> batch(batch_size);
+    std::size_t received = 0;
+    while(received < n_producers * n_messages){
+        const std::size_t n = queue.try_pop_n(batch.begin(), batch_size);
+        if(n == 0){
+            std::this_thread::yield();
+        }
+        for(std::size_t j = 0; j < n; ++j){
+            val += batch[j];
+        }
+        received += n;
+    }
+
+    for(auto & t : producers){
+        t.join();
+    }
+
+    t2 = cl::now();
+
+    std::cout << queue_name << "; " << n_producers << "; " << double(boost::chrono::duration_cast<nanoseconds>(t2 -t1).count())/(n_producers * n_messages) << ";" << std::endl;
+
+    return val;
+}
+
+
+
+int main(){
+
+    const std::size_t n_messages = 1000000, batch_size = 64;
+    const std::size_t n_producers = std::max<std::size_t>(2, std::thread::hardware_concurrency() - 1);
+    std::size_t junk=0;
+
+    hadoken::format::scat(std::cout, "\n# test queues for ", n_messages, " messages per producer \n");
+    hadoken::format::scat(std::cout, "queue; producers; time per message (ns); \n");
+
+    // single producer
+    junk += queue_test<hadoken::concurrent_queue_stl_mut<std::size_t> >(1, n_messages, "stl_mut");
+
+    junk += queue_test<hadoken::concurrent_queue_ring_mpmc<std::size_t> >(1, n_messages, "ring_mpmc");
+
+    junk += queue_test<hadoken::concurrent_queue_ring_mpsc<std::size_t> >(1, n_messages, "ring_mpsc");
+
+    junk += queue_test<hadoken::concurrent_queue_ring_spsc<std::size_t> >(1, n_messages, "ring_spsc");
+
+    junk += queue_test_batch<hadoken::concurrent_queue_ring_mpsc<std::size_t> >(1, n_messages, batch_size, "ring_mpsc_batch");
+
+    junk += queue_test_batch<hadoken::concurrent_queue_ring_spsc<std::size_t> >(1, n_messages, batch_size, "ring_spsc_batch");
+
+    // multiple producers
+    junk += queue_test<hadoken::concurrent_queue_stl_mut<std::size_t> >(n_producers, n_messages, "stl_mut");
+
+    junk += queue_test<hadoken::concurrent_queue_ring_mpmc<std::size_t> >(n_producers, n_messages, "ring_mpmc");
+
+    junk += queue_test<hadoken::concurrent_queue_ring_mpsc<std::size_t> >(n_producers, n_messages, "ring_mpsc");
+
+    junk += queue_test_batch<hadoken::concurrent_queue_ring_mpsc<std::size_t> >(n_producers, n_messages, batch_size, "ring_mpsc_batch");
+
+    std::cout << "# end junk " << junk << std::endl;
+
+}
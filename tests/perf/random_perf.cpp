@@ -35,6 +35,9 @@
 
 #include <boost/random.hpp>
 #include <boost/chrono.hpp>
+#include <numeric>
+#include <string>
+#include <vector>
 
 #include <hadoken/random/random.hpp>
 
@@ -290,6 +293,127 @@ std::size_t test_random_threefry_block_fake(std::size_t iter){
 }
 
 
+std::size_t test_random_threefry_batch(std::size_t iter){
+
+    typedef hadoken::threefry4x64 cipher_type;
+
+    std::size_t res =0;
+
+    tp t1, t2;
+
+    cipher_type cipher;
+
+    const std::size_t size_block = sizeof(cipher_type::range_type) / sizeof(std::size_t);
+    const std::size_t n_batch = 1024;
+
+    std::vector<cipher_type::domain_type> counters(n_batch);
+    std::vector<cipher_type::range_type> blocks(n_batch);
+
+    t1 = cl::now();
+
+    for(std::size_t i =0; i < (iter/size_block); i += n_batch){
+        for(std::size_t j = 0; j < n_batch; ++j){
+            counters[j][0] = i + j;
+        }
+
+        cipher.batch(counters.data(), n_batch, blocks.data());
+
+        for(std::size_t j = 0; j < n_batch; ++j){
+            res += blocks[j][0];
+        }
+    }
+
+
+    t2 = cl::now();
+
+    std::cout << "threefry batch gen: " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    return res;
+
+}
+
+
+std::size_t test_random_threefry_fill(std::size_t iter){
+
+    std::size_t res =0;
+
+    tp t1, t2;
+
+    hadoken::counter_engine<hadoken::threefry4x64> threefry_engine;
+
+    const std::size_t n_buffer = 4096;
+    std::vector<std::uint64_t> buffer(n_buffer);
+
+    t1 = cl::now();
+
+    for(std::size_t i =0; i < iter; i += n_buffer){
+        threefry_engine.fill(buffer.data(), buffer.size());
+        // consume the whole block, the fill can not be partially elided
+        res = std::accumulate(buffer.begin(), buffer.end(), res);
+    }
+
+
+    t2 = cl::now();
+
+    std::cout << "threefry bulk fill: " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    return res;
+
+}
+
+
+template<typename CBRNG>
+std::size_t test_random_counter_engine(std::size_t iter, const std::string & name){
+
+    std::size_t res =0;
+
+    tp t1, t2;
+
+    boost::random::uniform_int_distribution<std::size_t> dist;
+
+    hadoken::counter_engine<CBRNG> engine;
+
+    t1 = cl::now();
+
+    for(std::size_t i =0; i < iter; ++i){
+        res += dist(engine);
+    }
+
+
+    t2 = cl::now();
+
+    std::cout << name << ": " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    return res;
+
+}
+
+
+template<typename CBRNG>
+std::size_t test_random_counter_engine_fill(std::size_t iter, const std::string & name){
+
+    std::size_t res =0;
+
+    tp t1, t2;
+
+    hadoken::counter_engine<CBRNG> engine;
+
+    const std::size_t n_buffer = 4096;
+    std::vector<typename hadoken::counter_engine<CBRNG>::result_type> buffer(n_buffer);
+
+    t1 = cl::now();
+
+    for(std::size_t i =0; i < iter; i += n_buffer){
+        engine.fill(buffer.data(), buffer.size());
+        res = std::accumulate(buffer.begin(), buffer.end(), res);
+    }
+
+
+    t2 = cl::now();
+
+    std::cout << name << " bulk fill: " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    return res;
+
+}
+
+
 int main(){
 
     const std::size_t n_exec = 10000000;
@@ -321,6 +445,24 @@ int main(){
     junk += test_random_threefry_block_fake(n_exec);
 
 
+    junk += test_random_threefry_batch(n_exec);
+
+
+    junk += test_random_threefry_fill(n_exec);
+
+
+    junk += test_random_counter_engine<hadoken::philox4x32>(n_exec, "philox4x32");
+
+
+    junk += test_random_counter_engine<hadoken::philox4x64>(n_exec, "philox4x64");
+
+
+    junk += test_random_counter_engine_fill<hadoken::philox4x32>(n_exec, "philox4x32");
+
+
+    junk += test_random_counter_engine_fill<hadoken::philox4x64>(n_exec, "philox4x64");
+
+
     junk += test_random_abstract_threefry(n_exec);
 
     std::cout << "end junk " << junk << std::endl;
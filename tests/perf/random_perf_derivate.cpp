@@ -36,6 +36,8 @@
 #include <boost/random.hpp>
 #include <boost/chrono.hpp>
 
+#include <string>
+
 #include <hadoken/random/random.hpp>
 
 
@@ -269,6 +271,32 @@ std::size_t test_random_threefry(std::size_t iter){
 }
 
 
+template<typename Engine, typename DerivatePolicy>
+std::size_t test_random_derivate_policy(std::size_t iter, const std::string & name){
+
+    std::size_t res =0;
+
+    tp t1, t2;
+
+    boost::random::uniform_int_distribution<std::size_t> dist;
+    Engine engine;
+
+    t1 = cl::now();
+
+    for(std::size_t i =0; i < iter; ++i){
+        Engine derivated_engine = hadoken::random_engine_derivate(engine, 1, DerivatePolicy());
+        res += dist(derivated_engine);
+    }
+
+
+    t2 = cl::now();
+
+    std::cout << name << ": " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    return res;
+
+}
+
+
 int main(){
 
     const std::size_t n_exec = 1000000;
@@ -299,6 +327,18 @@ int main(){
 
     junk += test_random_abstract_threefry(n_exec);
 
+
+    junk += test_random_derivate_policy<boost::random::mt19937, hadoken::derivate_sha1_policy>(n_exec, "mersenne_twister sha1 policy");
+
+
+    junk += test_random_derivate_policy<boost::random::mt19937, hadoken::derivate_threefry_policy>(n_exec, "mersenne_twister threefry policy");
+
+
+    junk += test_random_derivate_policy<boost::random::taus88, hadoken::derivate_sha1_policy>(n_exec, "tau88 sha1 policy");
+
+
+    junk += test_random_derivate_policy<boost::random::taus88, hadoken::derivate_threefry_policy>(n_exec, "tau88 threefry policy");
+
     std::cout << "end junk " << junk << std::endl;
 
 }
@@ -32,7 +32,9 @@
 
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
 
 #include <boost/test/unit_test.hpp>
 #include <boost/mpl/list.hpp>
@@ -276,3 +278,240 @@ BOOST_AUTO_TEST_CASE_TEMPLATE( concurrent_queue_test_pthread, T, small_vector_ty
     BOOST_CHECK_EQUAL(queue.size(), 0);
 
 }
+
+
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( concurrent_queue_ring_mpmc_test, T, small_vector_types )
+{
+
+    using namespace hadoken;
+
+    constexpr std::size_t nb_producers = 4, nb_consumers = 4, nb_items_per_producer = 2000;
+
+    content_generator<T> gen;
+
+    // small capacity on purpose to stress the full queue case
+    concurrent_queue_ring_mpmc<T> queue(60);
+
+    BOOST_CHECK_EQUAL(queue.capacity(), 64);
+    BOOST_CHECK_EQUAL(queue.size(), 0);
+    BOOST_CHECK_EQUAL(queue.empty(), true);
+    BOOST_CHECK(! queue.try_pop());
+    BOOST_CHECK(! queue.try_pop(std::chrono::milliseconds(1)));
+
+    // bounded
+    for(std::size_t i =0; i < queue.capacity(); ++i){
+        BOOST_CHECK(queue.try_push(gen(i)));
+    }
+    T extra = gen(0);
+    BOOST_CHECK(queue.try_push(extra) == false);
+    BOOST_CHECK_EQUAL(queue.size(), queue.capacity());
+
+    for(std::size_t i =0; i < queue.capacity(); ++i){
+        auto item = queue.try_pop();
+        BOOST_CHECK(item);
+        BOOST_CHECK_EQUAL(item.get(), gen(i));
+    }
+    BOOST_CHECK_EQUAL(queue.empty(), true);
+
+    std::vector<std::thread> producers, consumers;
+    std::vector<T> expected, received;
+    std::mutex received_lock;
+    std::atomic<std::size_t> counter(0);
+
+    for(std::size_t p = 0; p < nb_producers; ++p){
+        for(std::size_t i = 0; i < nb_items_per_producer; ++i){
+            expected.push_back(gen(i));
+        }
+
+        producers.emplace_back([&](){
+            for(std::size_t i = 0; i < nb_items_per_producer; ++i){
+                queue.push(gen(i));
+            }
+        });
+    }
+
+    for(std::size_t c = 0; c < nb_consumers; ++c){
+        consumers.emplace_back([&](){
+            while(counter.load() < nb_producers * nb_items_per_producer){
+                auto item = queue.try_pop(std::chrono::milliseconds(1));
+                if(item){
+                    counter++;
+                    std::lock_guard<std::mutex> l(received_lock);
+                    received.emplace_back(std::move(item.get()));
+                }
+            }
+        });
+    }
+
+    for(auto & t : producers){
+        t.join();
+    }
+
+    for(auto & t : consumers){
+        t.join();
+    }
+
+    BOOST_CHECK_EQUAL(counter.load(), nb_producers * nb_items_per_producer);
+    BOOST_CHECK_EQUAL(queue.empty(), true);
+
+    // every element is received exactly once
+    std::sort(expected.begin(), expected.end());
+    std::sort(received.begin(), received.end());
+    BOOST_CHECK(expected == received);
+}
+
+
+BOOST_AUTO_TEST_CASE( concurrent_queue_thread_model_selection )
+{
+    using namespace hadoken;
+
+    static_assert(std::is_same<concurrent_queue<int>, concurrent_queue_stl_mut<int> >::value,
+                  "default concurrent_queue should be mutex based");
+
+    static_assert(std::is_same<concurrent_queue<int, std_lockfree_thread_model>,
+                               concurrent_queue_ring_mpmc<int, std_lockfree_thread_model> >::value,
+                  "lockfree thread model concurrent_queue should be lock-free");
+
+    concurrent_queue<std::unique_ptr<int>, std_lockfree_thread_model> queue;
+
+    queue.push(std::unique_ptr<int>(new int(42)));
+    auto item = queue.try_pop();
+
+    BOOST_CHECK(item);
+    BOOST_CHECK_EQUAL(*(item.get()), 42);
+}
+
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( concurrent_queue_ring_spsc_test, T, small_vector_types )
+{
+
+    using namespace hadoken;
+
+    constexpr std::size_t nb_items = 20000, batch_size = 7;
+
+    content_generator<T> gen;
+
+    concurrent_queue_ring_spsc<T> queue(32);
+
+    BOOST_CHECK_EQUAL(queue.capacity(), 32);
+    BOOST_CHECK_EQUAL(queue.empty(), true);
+    BOOST_CHECK(! queue.try_pop());
+
+    for(std::size_t i =0; i < queue.capacity(); ++i){
+        BOOST_CHECK(queue.try_push(gen(i)));
+    }
+    BOOST_CHECK(queue.try_push(gen(0)) == false);
+
+    std::vector<T> popped;
+    BOOST_CHECK_EQUAL(queue.try_pop_n(std::back_inserter(popped), 100), queue.capacity());
+    for(std::size_t i =0; i < popped.size(); ++i){
+        BOOST_CHECK_EQUAL(popped[i], gen(i));
+    }
+    BOOST_CHECK_EQUAL(queue.empty(), true);
+
+    // one producer, one consumer, order is preserved
+    std::vector<T> items, received;
+    for(std::size_t i =0; i < nb_items; ++i){
+        items.emplace_back(gen(i));
+    }
+
+    std::thread producer([&](){
+        for(std::size_t i = 0; i < nb_items; i += batch_size){
+            const std::size_t n = std::min(batch_size, nb_items - i);
+            if(i % 2 == 0){
+                queue.push_n(items.begin() + i, n);
+            }else{
+                for(std::size_t j = 0; j < n; ++j){
+                    queue.push(items[i + j]);
+                }
+            }
+        }
+    });
+
+    while(received.size() < nb_items){
+        if(queue.try_pop_n(std::back_inserter(received), batch_size) == 0){
+            auto item = queue.try_pop(std::chrono::milliseconds(1));
+            if(item){
+                received.emplace_back(std::move(item.get()));
+            }
+        }
+    }
+
+    producer.join();
+
+    BOOST_CHECK(items == received);
+    BOOST_CHECK_EQUAL(queue.empty(), true);
+}
+
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( concurrent_queue_ring_mpsc_test, T, small_vector_types )
+{
+
+    using namespace hadoken;
+
+    constexpr std::size_t nb_producers = 4, nb_items_per_producer = 5000, batch_size = 5;
+
+    content_generator<T> gen;
+
+    concurrent_queue_ring_mpsc<T> queue(32);
+
+    BOOST_CHECK_EQUAL(queue.capacity(), 32);
+    BOOST_CHECK_EQUAL(queue.empty(), true);
+    BOOST_CHECK(! queue.try_pop());
+
+    for(std::size_t i =0; i < queue.capacity(); ++i){
+        BOOST_CHECK(queue.try_push(gen(i)));
+    }
+    BOOST_CHECK(queue.try_push(gen(0)) == false);
+
+    std::vector<T> popped;
+    BOOST_CHECK_EQUAL(queue.try_pop_n(std::back_inserter(popped), 100), queue.capacity());
+    for(std::size_t i =0; i < popped.size(); ++i){
+        BOOST_CHECK_EQUAL(popped[i], gen(i));
+    }
+    BOOST_CHECK_EQUAL(queue.empty(), true);
+
+    // several producers, one consumer
+    std::vector<T> items, expected, received;
+    for(std::size_t i =0; i < nb_items_per_producer; ++i){
+        items.emplace_back(gen(i));
+    }
+
+    std::vector<std::thread> producers;
+    for(std::size_t p = 0; p < nb_producers; ++p){
+        expected.insert(expected.end(), items.begin(), items.end());
+
+        producers.emplace_back([&, p](){
+            for(std::size_t i = 0; i < nb_items_per_producer; i += batch_size){
+                const std::size_t n = std::min(batch_size, nb_items_per_producer - i);
+                if(p % 2 == 0){
+                    queue.push_n(items.begin() + i, n);
+                }else{
+                    for(std::size_t j = 0; j < n; ++j){
+                        queue.push(items[i + j]);
+                    }
+                }
+            }
+        });
+    }
+
+    while(received.size() < nb_producers * nb_items_per_producer){
+        if(queue.try_pop_n(std::back_inserter(received), batch_size) == 0){
+            auto item = queue.try_pop(std::chrono::milliseconds(1));
+            if(item){
+                received.emplace_back(std::move(item.get()));
+            }
+        }
+    }
+
+    for(auto & t : producers){
+        t.join();
+    }
+
+    BOOST_CHECK_EQUAL(queue.empty(), true);
+
+    std::sort(expected.begin(), expected.end());
+    std::sort(received.begin(), received.end());
+    BOOST_CHECK(expected == received);
+}
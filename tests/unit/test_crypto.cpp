@@ -32,6 +32,14 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <system_error>
+#include <cstdlib>
+
+#include <unistd.h>
 
 
 #include <boost/integer.hpp>
@@ -40,6 +48,8 @@
 #include <boost/test/floating_point_comparison.hpp>
 
 #include <hadoken/crypto/crypto.hpp>
+#include <hadoken/crypto/hash_file.hpp>
+#include <hadoken/string/string_view.hpp>
 
 
 
@@ -112,3 +122,311 @@ BOOST_AUTO_TEST_CASE( hash_integer )
 
 }
 
+
+
+BOOST_AUTO_TEST_CASE( sha1_multi_block )
+{
+    // FIPS 180 long message vector: one million 'a'
+    const std::string str(1000000, 'a');
+
+    hadoken::sha1 sha_compute;
+    sha_compute.process_block(str.data(), str.size());
+
+    BOOST_CHECK_EQUAL("34aa973cd4c4daa4f61eeb2bdbad27316534016f", sha_compute.to_string());
+
+    // message length of 55, 56, 63 and 64 bytes trigger the different padding cases
+    const std::vector<std::pair<std::size_t, std::string> > padding_vectors = {
+        { 55, "c1c8bbdc22796e28c0e15163d20899b65621d65a" },
+        { 56, "c2db330f6083854c99d4b5bfb6e8f29f201be699" },
+        { 63, "03f09f5b158a7a8cdad920bddc29b81c18a551f5" },
+        { 64, "0098ba824b5c16427bd7a1122a5a442a25ec644d" }
+    };
+
+    for(const auto & v : padding_vectors){
+        hadoken::sha1 sha_pad;
+        sha_pad.process_block(str.data(), v.first);
+        BOOST_CHECK_EQUAL(v.second, sha_pad.to_string());
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( sha1_split_feed )
+{
+    std::vector<std::uint8_t> data(1031);
+    for(std::size_t i = 0; i < data.size(); ++i){
+        data[i] = static_cast<std::uint8_t>((i * 131 + 7) & 0xFF);
+    }
+
+    hadoken::sha1 reference;
+    reference.process_block(data.begin(), data.end());
+    const std::string ref = reference.to_string();
+
+    // feed by chunks of every size, unaligned on the block boundaries
+    for(std::size_t chunk = 1; chunk < 150; chunk += 7){
+        hadoken::sha1 sha_compute;
+        for(std::size_t pos = 0; pos < data.size(); pos += chunk){
+            const std::size_t len = std::min(chunk, data.size() - pos);
+            sha_compute.process_block(&data[pos], len);
+        }
+        BOOST_CHECK_EQUAL(ref, sha_compute.to_string());
+    }
+
+    // byte by byte
+    hadoken::sha1 sha_bytes;
+    for(std::uint8_t b : data){
+        sha_bytes.process(b);
+    }
+    BOOST_CHECK_EQUAL(ref, sha_bytes.to_string());
+
+    // reset and re-use
+    sha_bytes.reset();
+    sha_bytes.process_block(&data[0], data.size());
+    BOOST_CHECK_EQUAL(ref, sha_bytes.to_string());
+}
+
+
+BOOST_AUTO_TEST_CASE( sha1_compress_backends )
+{
+    std::vector<std::uint8_t> data(64 * 33);
+    std::uint32_t x = 0x12345678;
+    for(auto & b : data){
+        x = x * 1664525u + 1013904223u;
+        b = static_cast<std::uint8_t>(x >> 24);
+    }
+
+    std::uint32_t state_generic[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+    std::uint32_t state_dispatch[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+
+    hadoken::impl::sha1_compress_generic(state_generic, &data[0], data.size() / 64);
+    hadoken::impl::sha1_compress(state_dispatch, &data[0], data.size() / 64);
+
+    BOOST_CHECK_EQUAL_COLLECTIONS(state_generic, state_generic + 5, state_dispatch, state_dispatch + 5);
+
+#ifdef HADOKEN_SHA1_SHANI_BACKEND
+    std::cout << "sha1 SHA-NI backend available: " << hadoken::impl::sha1_cpu_has_shani() << "\n";
+
+    if(hadoken::impl::sha1_cpu_has_shani()){
+        std::uint32_t state_shani[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+
+        // block by block, to check the state round trip
+        for(std::size_t i = 0; i < data.size() / 64; ++i){
+            hadoken::impl::sha1_compress_shani(state_shani, &data[i * 64], 1);
+        }
+        BOOST_CHECK_EQUAL_COLLECTIONS(state_generic, state_generic + 5, state_shani, state_shani + 5);
+    }
+#endif
+}
+
+
+BOOST_AUTO_TEST_CASE( sha1_multi_buffer )
+{
+    // messages of every size around the block and padding boundaries
+    std::vector<std::string> messages;
+    for(std::size_t i = 0; i < 200; ++i){
+        std::string msg(i * 3 % 257, '\0');
+        for(std::size_t j = 0; j < msg.size(); ++j){
+            msg[j] = static_cast<char>((i * 31 + j * 7) & 0xFF);
+        }
+        messages.push_back(msg);
+    }
+    messages.push_back("hello world");
+
+    for(auto backend : { hadoken::sha1_multi::backend_auto, hadoken::sha1_multi::backend_lanes }){
+        hadoken::sha1_multi hasher(backend);
+        std::cout << "sha1_multi lanes: " << hasher.lanes() << "\n";
+
+        const std::vector<hadoken::sha1::digest32_t> digests = hasher.hash(messages);
+
+        BOOST_REQUIRE_EQUAL(digests.size(), messages.size());
+
+        for(std::size_t i = 0; i < messages.size(); ++i){
+            hadoken::sha1 sha_compute;
+            sha_compute.process_block(messages[i].data(), messages[i].size());
+
+            BOOST_CHECK_EQUAL(sha_compute.to_string(), hadoken::sha1_multi::to_string(digests[i]));
+        }
+
+        BOOST_CHECK_EQUAL("2aae6c35c94fcfb415dbe95f408b9ce91ee846ed", hadoken::sha1_multi::to_string(digests.back()));
+    }
+
+    hadoken::sha1_multi hasher(hadoken::sha1_multi::backend_lanes);
+
+    // any span like type
+    std::vector<hadoken::string_view> views = { hadoken::string_view("hello world"), hadoken::string_view("") };
+    const std::vector<hadoken::sha1::digest32_t> view_digests = hasher.hash(views.begin(), views.end());
+    BOOST_CHECK_EQUAL("2aae6c35c94fcfb415dbe95f408b9ce91ee846ed", hadoken::sha1_multi::to_string(view_digests[0]));
+    BOOST_CHECK_EQUAL("da39a3ee5e6b4b0d3255bfef95601890afd80709", hadoken::sha1_multi::to_string(view_digests[1]));
+
+    BOOST_CHECK(hasher.hash(std::vector<std::string>()).empty());
+}
+
+
+
+namespace {
+
+std::string write_temporary_file(const std::vector<char> & content){
+    char path[] = "/tmp/hadoken_hash_file_XXXXXX";
+    const int fd = ::mkstemp(path);
+    BOOST_REQUIRE(fd >= 0);
+    ::close(fd);
+
+    std::ofstream out(path, std::ios::out | std::ios::binary);
+    out.write(content.data(), static_cast<std::streamsize>(content.size()));
+    return std::string(path);
+}
+
+std::vector<char> make_content(std::size_t size){
+    std::vector<char> content(size);
+    for(std::size_t i = 0; i < size; ++i){
+        content[i] = static_cast<char>((i * 2654435761u) >> 13);
+    }
+    return content;
+}
+
+}
+
+
+BOOST_AUTO_TEST_CASE( hash_file_methods )
+{
+    using namespace hadoken::crypto;
+
+    for(std::size_t size : { 0, 1, 63, 64, 1000, 3 * 1024 * 1024 + 17, 9 * 1024 * 1024 + 5 }){
+        const std::vector<char> content = make_content(size);
+        const std::string path = write_temporary_file(content);
+
+        hadoken::sha1 reference;
+        reference.process_block(content.data(), content.size());
+        const hadoken::sha1::digest32_t ref_digest = reference.get_digest();
+
+        BOOST_CHECK(hash_file(path) == ref_digest);
+        BOOST_CHECK(hash_file(path, hash_file_method::read) == ref_digest);
+        if(size > 0){
+            BOOST_CHECK(hash_file(path, hash_file_method::mmap) == ref_digest);
+        }
+
+        std::remove(path.c_str());
+    }
+
+    BOOST_CHECK_THROW(hash_file("/tmp/hadoken_this_file_does_not_exist"), std::system_error);
+}
+
+
+BOOST_AUTO_TEST_CASE( hash_file_tree_mode )
+{
+    using namespace hadoken::crypto;
+
+    const std::size_t chunk_size = 1000;
+    const std::vector<char> content = make_content(10017);
+    const std::string path = write_temporary_file(content);
+
+    // root = sha1 of the concatenated big endian leaf digests
+    hadoken::sha1 root;
+    for(std::size_t offset = 0; offset < content.size(); offset += chunk_size){
+        hadoken::sha1 leaf;
+        leaf.process_block(&content[offset], std::min(chunk_size, content.size() - offset));
+        for(std::uint32_t word : leaf.get_digest()){
+            root.process(word);
+        }
+    }
+    const hadoken::sha1::digest32_t ref_digest = root.get_digest();
+
+    BOOST_CHECK(hash_file_tree(hadoken::parallel::seq, path, chunk_size) == ref_digest);
+    BOOST_CHECK(hash_file_tree(hadoken::parallel::par, path, chunk_size) == ref_digest);
+
+    // a single chunk is the hash of the file digest
+    hadoken::sha1 single_root;
+    for(std::uint32_t word : hash_file(path)){
+        single_root.process(word);
+    }
+    BOOST_CHECK(hash_file_tree(hadoken::parallel::par, path) == single_root.get_digest());
+
+    BOOST_CHECK_THROW(hash_file_tree(hadoken::parallel::par, path, 0), std::invalid_argument);
+    BOOST_CHECK_THROW(hash_file_tree(hadoken::parallel::par, "/tmp/hadoken_this_file_does_not_exist"), std::system_error);
+
+    std::remove(path.c_str());
+}
+
+
+BOOST_AUTO_TEST_CASE( fast_hash_reference_vectors )
+{
+    using namespace hadoken::crypto;
+
+    std::string pattern;
+    for(int i = 0; i < 3 * 256; ++i){
+        pattern.push_back(static_cast<char>(i & 0xFF));
+    }
+
+    struct reference{
+        std::string input;
+        std::uint64_t xxh64_seed0, xxh64_seed42;
+        hash128_t murmur3_seed0, murmur3_seed42;
+    };
+
+    // reference values from the xxHash and MurmurHash3 reference implementations
+    const std::vector<reference> references = {
+        { "", 0xef46db3751d8e999ULL, 0x98b1582b0977e704ULL,
+          {{ 0x0ULL, 0x0ULL }}, {{ 0xf02aa77dfa1b8523ULL, 0xd1016610da11cbb9ULL }} },
+        { "a", 0xd24ec4f1a98c6e5bULL, 0x88e4fe59adf7b0ccULL,
+          {{ 0x85555565f6597889ULL, 0xe6b53a48510e895aULL }}, {{ 0x28259ca4fdf626b0ULL, 0x25ebca9125f82b15ULL }} },
+        { "abc", 0x44bc2cf5ad770999ULL, 0x13c1d910702770e6ULL,
+          {{ 0xb4963f3f3fad7867ULL, 0x3ba2744126ca2d52ULL }}, {{ 0x0d85089fb3cff7d6ULL, 0x7510712b42353d30ULL }} },
+        { "hello world", 0x45ab6734b21e6968ULL, 0x69c2b68f9d9352a1ULL,
+          {{ 0x533f6046eb7f610eULL, 0xab97467d60eb63b1ULL }}, {{ 0xc05292b747fc78c0ULL, 0x85bdab5e19e59315ULL }} },
+        { pattern, 0x8e03c838c596036fULL, 0x5a08dead05df1080ULL,
+          {{ 0xcf926c3003b926b6ULL, 0xfa53d9e5e2f34638ULL }}, {{ 0x714a8df84dbf9b10ULL, 0x14f6953a1cba68ebULL }} }
+    };
+
+    for(const reference & ref : references){
+        BOOST_CHECK_EQUAL(hash64(ref.input), ref.xxh64_seed0);
+        BOOST_CHECK_EQUAL(hash64(ref.input.data(), ref.input.size(), 42), ref.xxh64_seed42);
+        BOOST_CHECK_EQUAL(static_hash64(ref.input.data(), ref.input.size(), 42), ref.xxh64_seed42);
+
+        BOOST_CHECK(hash128(ref.input) == ref.murmur3_seed0);
+        BOOST_CHECK(hash128(ref.input.data(), ref.input.size(), 42) == ref.murmur3_seed42);
+    }
+
+    // compile time hashing
+    static_assert(static_hash64("hello world") == 0x45ab6734b21e6968ULL, "static_hash64 is not a constant expression");
+    static_assert(static_hash64("abc", 3, 42) == 0x13c1d910702770e6ULL, "static_hash64 is not a constant expression");
+}
+
+
+BOOST_AUTO_TEST_CASE( fast_hash_streaming )
+{
+    using namespace hadoken::crypto;
+
+    std::vector<std::uint8_t> data(1000);
+    for(std::size_t i = 0; i < data.size(); ++i){
+        data[i] = static_cast<std::uint8_t>((i * 131 + 7) & 0xFF);
+    }
+
+    for(std::size_t len : { 0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 1000 }){
+        const std::uint64_t ref64 = hash64(data.data(), len, 7);
+        const hash128_t ref128 = hash128(data.data(), len, 7);
+
+        for(std::size_t chunk = 1; chunk < 70; chunk += 3){
+            hasher64 h64(7);
+            hasher128 h128(7);
+
+            for(std::size_t pos = 0; pos < len; pos += chunk){
+                const std::size_t n = std::min(chunk, len - pos);
+                h64.update(&data[pos], n);
+                h128.update(&data[pos], n);
+            }
+
+            BOOST_CHECK_EQUAL(h64.digest(), ref64);
+            BOOST_CHECK(h128.digest() == ref128);
+        }
+    }
+
+    hasher64 h64;
+    h64.update(hadoken::string_view("hello "));
+    h64.update(hadoken::string_view("world"));
+    BOOST_CHECK_EQUAL(h64.digest(), static_hash64("hello world"));
+
+    h64.reset();
+    BOOST_CHECK_EQUAL(h64.digest(), hash64(""));
+
+    string_hash hasher;
+    BOOST_CHECK_EQUAL(hasher(std::string("hello world")), static_cast<std::size_t>(0x45ab6734b21e6968ULL));
+}
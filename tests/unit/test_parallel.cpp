@@ -37,12 +37,26 @@
 #include <algorithm>
 #include <random>
 #include <numeric>
+#include <list>
+#include <cmath>
+#include <limits>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <forward_list>
+#include <thread>
+#include <memory>
+#include <iterator>
+#include <string>
+#include <cstdint>
 
 #include <chrono>
 
 #include <boost/test/unit_test.hpp>
 
 #include <hadoken/parallel/algorithm.hpp>
+#include <hadoken/random/random.hpp>
+#include <hadoken/executor/thread_pool_executor.hpp>
 
 //#include <parallel/algorithm>
 
@@ -241,6 +255,65 @@ BOOST_AUTO_TEST_CASE( parallel_count_test)
 }
 
 
+BOOST_AUTO_TEST_CASE( parallel_reduce_test)
+{
+
+    using namespace hadoken;
+
+    for(std::size_t n : { 0, 1, 3, 9, 1000, 100003 }){
+        std::vector<std::int64_t> values(n), weights(n);
+        for(std::size_t i = 0; i < n; ++i){
+            values[i] = static_cast<std::int64_t>(i % 23) - 11;
+            weights[i] = static_cast<std::int64_t>(i % 5);
+        }
+
+        const std::int64_t ref_sum = std::accumulate(values.begin(), values.end(), std::int64_t(7));
+        const std::int64_t ref_dot = std::inner_product(values.begin(), values.end(), weights.begin(), std::int64_t(0));
+        const std::int64_t ref_max = std::accumulate(values.begin(), values.end(), std::int64_t(-100),
+                                                     [](std::int64_t a, std::int64_t b){ return std::max(a, b); });
+        std::int64_t ref_squares = 0;
+        for(auto v : values){
+            ref_squares += v * v;
+        }
+
+        const auto max_op = [](std::int64_t a, std::int64_t b){ return std::max(a, b); };
+        const auto square = [](std::int64_t v){ return v * v; };
+
+        BOOST_CHECK_EQUAL(parallel::reduce(parallel::seq, values.begin(), values.end(), std::int64_t(7)), ref_sum);
+        BOOST_CHECK_EQUAL(parallel::reduce(parallel::par, values.begin(), values.end(), std::int64_t(7)), ref_sum);
+        BOOST_CHECK_EQUAL(parallel::reduce(parallel::par_vec, values.begin(), values.end(), std::int64_t(7)), ref_sum);
+        BOOST_CHECK_EQUAL(parallel::reduce(parallel::par, values.begin(), values.end()), ref_sum - 7);
+
+        BOOST_CHECK_EQUAL(parallel::reduce(parallel::par, values.begin(), values.end(), std::int64_t(-100), max_op), ref_max);
+        BOOST_CHECK_EQUAL(parallel::reduce(parallel::par_vec, values.begin(), values.end(), std::int64_t(-100), max_op), ref_max);
+
+        BOOST_CHECK_EQUAL(parallel::transform_reduce(parallel::seq, values.begin(), values.end(), weights.begin(), std::int64_t(0)), ref_dot);
+        BOOST_CHECK_EQUAL(parallel::transform_reduce(parallel::par, values.begin(), values.end(), weights.begin(), std::int64_t(0)), ref_dot);
+        BOOST_CHECK_EQUAL(parallel::transform_reduce(parallel::par_vec, values.begin(), values.end(), weights.begin(), std::int64_t(0)), ref_dot);
+
+        BOOST_CHECK_EQUAL(parallel::transform_reduce(parallel::par, values.begin(), values.end(), std::int64_t(0),
+                                                     std::plus<std::int64_t>(), square), ref_squares);
+        BOOST_CHECK_EQUAL(parallel::transform_reduce(parallel::par_vec, values.begin(), values.end(), std::int64_t(0),
+                                                     std::plus<std::int64_t>(), square), ref_squares);
+    }
+
+    // floating point under par_vec: reordered, close to the sequential sum
+    std::vector<double> reals(100003);
+    for(std::size_t i = 0; i < reals.size(); ++i){
+        reals[i] = 1.0 / static_cast<double>(i + 1);
+    }
+    const double ref_real = std::accumulate(reals.begin(), reals.end(), 0.0);
+    BOOST_CHECK_CLOSE(parallel::reduce(parallel::par_vec, reals.begin(), reals.end(), 0.0), ref_real, 1e-9);
+    BOOST_CHECK_CLOSE(parallel::reduce(parallel::par, reals.begin(), reals.end(), 0.0), ref_real, 1e-9);
+
+    // forward iterators
+    std::list<int> list_values(1000, 2);
+    BOOST_CHECK_EQUAL(parallel::reduce(parallel::par, list_values.begin(), list_values.end(), 0), 2000);
+    BOOST_CHECK_EQUAL(parallel::count(parallel::par, list_values.begin(), list_values.end(), 2), 1000);
+}
+
+
+
 BOOST_AUTO_TEST_CASE( parallel_transform_test)
 {
 
@@ -596,12 +669,31 @@ BOOST_AUTO_TEST_CASE( parallel_sort)
         
         auto t2 = cl::now();
 
-        std::cout << " sort sequential " << std::chrono::duration_cast<std::chrono::microseconds>(t2 -t1).count() << std::endl;        
-        
+        std::cout << " sort sequential " << std::chrono::duration_cast<std::chrono::microseconds>(t2 -t1).count() << std::endl;
+
         BOOST_CHECK( is_ordered(v3) == true);
+
+        auto v4 = values;
+        parallel::sort(parallel::par_vec, v4.begin(), v4.end());
+        BOOST_CHECK_EQUAL_COLLECTIONS(v3.begin(), v3.end(), v4.begin(), v4.end());
     }
 
-  
+    // with comparator and non trivial type
+    {
+        std::vector<std::string> str_values(n), str_sorted;
+        std::uniform_int_distribution<int> small_dist(0, 1000);
+
+        std::generate(str_values.begin(), str_values.end(), [&](){
+            return std::to_string(small_dist(mt));
+        });
+
+        str_sorted = str_values;
+        std::sort(str_sorted.begin(), str_sorted.end(), std::greater<std::string>());
+
+        parallel::sort(parallel::par, str_values.begin(), str_values.end(), std::greater<std::string>());
+
+        BOOST_CHECK_EQUAL_COLLECTIONS(str_values.begin(), str_values.end(), str_sorted.begin(), str_sorted.end());
+    }
 
 }
 
@@ -671,3 +763,713 @@ BOOST_AUTO_TEST_CASE( parallel_inclusive_scan)
   
 
 }
+
+
+
+BOOST_AUTO_TEST_CASE( parallel_scan_variants)
+{
+
+    using namespace hadoken;
+
+    for(std::size_t n : { 0, 1, 2, 7, 1000, 100003 }){
+
+        std::vector<std::int64_t> values(n);
+        for(std::size_t i = 0; i < n; ++i){
+            values[i] = static_cast<std::int64_t>(i % 17) - 8;
+        }
+
+        // sequential references
+        std::vector<std::int64_t> ref_inclusive(n), ref_exclusive(n), ref_transform(n);
+        std::int64_t acc = 100;
+        for(std::size_t i = 0; i < n; ++i){
+            ref_exclusive[i] = acc;
+            acc += values[i];
+            ref_inclusive[i] = acc;
+        }
+        acc = 0;
+        for(std::size_t i = 0; i < n; ++i){
+            acc += values[i] * values[i];
+            ref_transform[i] = acc;
+        }
+
+        const auto square = [](std::int64_t v){ return v * v; };
+
+        for(int use_par = 0; use_par < 2; ++use_par){
+            std::vector<std::int64_t> res(n);
+
+            auto check_scan = [&](const std::vector<std::int64_t> & ref, std::vector<std::int64_t>::iterator end_it){
+                BOOST_CHECK(end_it == res.end());
+                BOOST_CHECK(res == ref);
+            };
+
+            if(use_par){
+                check_scan(ref_inclusive, parallel::inclusive_scan(parallel::par, values.begin(), values.end(), res.begin(), std::plus<std::int64_t>(), std::int64_t(100)));
+                check_scan(ref_exclusive, parallel::exclusive_scan(parallel::par, values.begin(), values.end(), res.begin(), std::int64_t(100)));
+                check_scan(ref_transform, parallel::transform_inclusive_scan(parallel::par, values.begin(), values.end(), res.begin(), std::plus<std::int64_t>(), square));
+            }else{
+                check_scan(ref_inclusive, parallel::inclusive_scan(parallel::seq, values.begin(), values.end(), res.begin(), std::plus<std::int64_t>(), std::int64_t(100)));
+                check_scan(ref_exclusive, parallel::exclusive_scan(parallel::seq, values.begin(), values.end(), res.begin(), std::int64_t(100)));
+                check_scan(ref_transform, parallel::transform_inclusive_scan(parallel::seq, values.begin(), values.end(), res.begin(), std::plus<std::int64_t>(), square));
+            }
+
+            // in place exclusive scan
+            res = values;
+            parallel::exclusive_scan(parallel::par, res.begin(), res.end(), res.begin(), std::int64_t(100), std::plus<std::int64_t>());
+            BOOST_CHECK(res == ref_exclusive);
+        }
+    }
+
+    // non commutative operation: the order of the slices is kept
+    std::vector<std::string> words;
+    for(int i = 0; i < 200; ++i){
+        words.push_back(std::string(1, static_cast<char>('a' + (i % 26))));
+    }
+    std::vector<std::string> concat_seq(words.size()), concat_par(words.size());
+
+    std::partial_sum(words.begin(), words.end(), concat_seq.begin());
+    parallel::inclusive_scan(parallel::par, words.begin(), words.end(), concat_par.begin());
+
+    BOOST_CHECK(concat_seq == concat_par);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( parallel_generate_random)
+{
+
+    using namespace hadoken;
+
+    typedef counter_engine<threefry4x64> engine_type;
+
+    std::size_t n = 100003;
+
+    std::vector<engine_type::result_type> v_seq(n), v_par(n), v_ref(n);
+
+    engine_type engine_seq(42), engine_par(42), engine_ref(42);
+
+    // start from the middle of a block
+    for(int i = 0; i < 3; ++i){
+        (void) engine_seq();
+        (void) engine_par();
+        (void) engine_ref();
+    }
+
+    parallel::generate_random(parallel::seq, v_seq.begin(), v_seq.end(), engine_seq);
+
+    {
+        auto t1 = cl::now();
+
+        parallel::generate_random(parallel::par, v_par.begin(), v_par.end(), engine_par);
+
+        auto t2 = cl::now();
+
+        std::cout << " generate_random parallel " << std::chrono::duration_cast<std::chrono::microseconds>(t2 -t1).count() << std::endl;
+    }
+
+    for(auto & v : v_ref){
+        v = engine_ref();
+    }
+
+    BOOST_CHECK(v_seq == v_ref);
+    BOOST_CHECK(v_par == v_ref);
+
+    // all engines continue the same stream
+    BOOST_CHECK(engine_seq == engine_ref);
+    BOOST_CHECK(engine_par == engine_ref);
+    BOOST_CHECK_EQUAL(engine_par(), engine_ref());
+
+}
+
+
+
+BOOST_AUTO_TEST_CASE( parallel_configurable_policy)
+{
+    using namespace hadoken;
+
+    std::vector<int> values(10000);
+    std::iota(values.begin(), values.end(), 0);
+
+    // thread count and grain bound the number of slices
+    {
+        std::atomic<int> n_calls(0);
+        parallel::for_range(parallel::par.with_threads(3), values.begin(), values.end(), [&](std::vector<int>::iterator b, std::vector<int>::iterator e){
+            (void) b; (void) e;
+            n_calls++;
+        });
+        BOOST_CHECK_LE(n_calls.load(), 3);
+        BOOST_CHECK_GE(n_calls.load(), 1);
+
+        n_calls = 0;
+        std::atomic<std::size_t> n_elems(0), min_elems(values.size());
+        parallel::for_range(parallel::par.with_threads(16).with_grain(4000), values.begin(), values.end(), [&](std::vector<int>::iterator b, std::vector<int>::iterator e){
+            const std::size_t local_elems = static_cast<std::size_t>(std::distance(b, e));
+            std::size_t current_min = min_elems.load();
+            while(local_elems < current_min && min_elems.compare_exchange_weak(current_min, local_elems) == false){}
+            n_elems += local_elems;
+            n_calls++;
+        });
+        BOOST_CHECK_LE(n_calls.load(), 2);
+        BOOST_CHECK_GE(min_elems.load(), 4000u);
+        BOOST_CHECK_EQUAL(n_elems.load(), values.size());
+    }
+
+    // settings are copied, par itself stays untouched
+    {
+        auto policy = parallel::par_vec.with_grain(128).with_threads(2);
+        BOOST_CHECK_EQUAL(policy.config().grain, 128u);
+        BOOST_CHECK_EQUAL(policy.config().n_threads, 2u);
+        BOOST_CHECK_EQUAL(parallel::par.config().grain, 1u);
+        BOOST_CHECK_EQUAL(parallel::par.config().n_threads, 0u);
+        BOOST_CHECK(parallel::par.config().executor.valid() == false);
+    }
+
+    // tasks run on the given executor
+    {
+        thread_pool_executor pool(4);
+
+        std::mutex lock;
+        std::set<std::thread::id> ids;
+
+        std::atomic<int> n_started(0);
+
+        // the first slice waits for a second one, that can only run in the pool
+        parallel::for_range(parallel::par.on(pool).with_threads(4), values.begin(), values.end(),
+                            [&](std::vector<int>::iterator b, std::vector<int>::iterator e){
+            (void) b; (void) e;
+            {
+                std::lock_guard<std::mutex> l(lock);
+                ids.insert(std::this_thread::get_id());
+            }
+
+            n_started++;
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+            while(n_started.load() < 2 && std::chrono::steady_clock::now() < deadline){
+                std::this_thread::yield();
+            }
+        });
+
+        BOOST_CHECK_GE(ids.size(), 2u);
+        ids.erase(std::this_thread::get_id());
+        BOOST_CHECK(ids.empty() == false);
+
+        auto policy = parallel::par.on(pool).with_threads(5).with_grain(64);
+
+        const long sum = parallel::reduce(policy, values.begin(), values.end(), 0L);
+        BOOST_CHECK_EQUAL(sum, std::accumulate(values.begin(), values.end(), 0L));
+
+        const auto n_even = parallel::count_if(policy, values.begin(), values.end(), [](int v){ return v % 2 == 0; });
+        BOOST_CHECK_EQUAL(n_even, 5000);
+
+        std::vector<long> scan_ref(values.size()), scan_par(values.size());
+        std::partial_sum(values.begin(), values.end(), scan_ref.begin());
+        parallel::inclusive_scan(policy, values.begin(), values.end(), scan_par.begin());
+        BOOST_CHECK(scan_ref == scan_par);
+
+        std::vector<int> sorted(values.rbegin(), values.rend());
+        parallel::sort(parallel::par.on(pool).with_threads(3), sorted.begin(), sorted.end());
+        BOOST_CHECK(sorted == values);
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE( parallel_schedule_test)
+{
+    using namespace hadoken;
+
+    const std::size_t n = 100003;
+
+    const parallel::schedule_type schedules[] = { parallel::schedule_type::static_split,
+                                                   parallel::schedule_type::dynamic,
+                                                   parallel::schedule_type::guided };
+
+    for(parallel::schedule_type schedule : schedules){
+        for(std::size_t grain : { std::size_t(1), std::size_t(7), std::size_t(5000), n * 2 }){
+            std::vector<int> visits(n, 0);
+            std::atomic<std::size_t> n_chunks(0), n_empty_chunks(0);
+
+            parallel::for_range(parallel::par.with_schedule(schedule).with_grain(grain), visits.begin(), visits.end(),
+                                [&](std::vector<int>::iterator b, std::vector<int>::iterator e){
+                if(b == e){
+                    n_empty_chunks++;
+                }
+                for(; b != e; ++b){
+                    *b += 1;
+                }
+                n_chunks++;
+            });
+
+            BOOST_CHECK(std::all_of(visits.begin(), visits.end(), [](int v){ return v == 1; }));
+            BOOST_CHECK_LE(n_chunks.load(), (n + grain - 1) / grain);
+            BOOST_CHECK_EQUAL(n_empty_chunks.load(), 0u);
+        }
+
+        // irregular workload
+        std::vector<double> values(2000), values_ref(2000);
+        std::iota(values.begin(), values.end(), 0.0);
+        std::iota(values_ref.begin(), values_ref.end(), 0.0);
+
+        auto skewed = [](double & v){
+            const int n_iter = (v > 1500) ? 200 : 1;
+            for(int i = 0; i < n_iter; ++i){
+                v = std::sqrt(v * v + 1.0);
+            }
+        };
+
+        std::for_each(values_ref.begin(), values_ref.end(), skewed);
+        parallel::for_each(parallel::par_vec.with_schedule(schedule), values.begin(), values.end(), skewed);
+        BOOST_CHECK(values == values_ref);
+
+        // non random access iterators are walked in segments
+        std::list<int> l(1000, 1);
+        parallel::for_each(parallel::par.with_schedule(schedule), l.begin(), l.end(), [](int & v){ v += 1; });
+        BOOST_CHECK_EQUAL(std::accumulate(l.begin(), l.end(), 0), 2000);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( parallel_fork_join_grid)
+{
+    using namespace hadoken;
+
+    std::vector<int> values(1000);
+    std::iota(values.begin(), values.end(), 0);
+
+    // exceptions of any slice are propagated to the caller
+    for(int i = 0; i < 10; ++i){
+        BOOST_CHECK_THROW(parallel::for_range(parallel::par.with_threads(4), values.begin(), values.end(),
+                                              [](std::vector<int>::iterator b, std::vector<int>::iterator e){
+            if(std::find(b, e, 999) != e){
+                throw std::runtime_error("slice error");
+            }
+        }), std::runtime_error);
+    }
+
+    // nested grids submitted from the threads of the executor
+    thread_pool_executor pool(2);
+    auto policy = parallel::par.on(pool).with_threads(4);
+
+    std::vector<long> sums(16, 0);
+    parallel::for_each(policy, sums.begin(), sums.end(), [&](long & s){
+        s = parallel::reduce(policy, values.begin(), values.end(), 0L);
+    });
+
+    const long ref = std::accumulate(values.begin(), values.end(), 0L);
+    BOOST_CHECK(std::all_of(sums.begin(), sums.end(), [ref](long s){ return s == ref; }));
+
+    // many small grids in a row
+    std::atomic<int> counter(0);
+    for(int i = 0; i < 1000; ++i){
+        parallel::for_range(policy, values.begin(), values.begin() + 8, [&](std::vector<int>::iterator b, std::vector<int>::iterator e){
+            counter += static_cast<int>(std::distance(b, e));
+        });
+    }
+    BOOST_CHECK_EQUAL(counter.load(), 8000);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( parallel_segmented_ranges)
+{
+    using namespace hadoken;
+
+    const int n = 10007;
+
+    std::set<int> s;
+    std::list<int> l;
+    std::forward_list<std::string> words;
+    for(int i = 0; i < n; ++i){
+        s.insert(i);
+        l.push_back(i);
+    }
+    for(int i = 0; i < 3000; ++i){
+        words.push_front(std::string(1, static_cast<char>('a' + (i % 26))));
+    }
+
+    for(std::size_t n_threads : { std::size_t(1), std::size_t(3), std::size_t(8) }){
+        for(std::size_t grain : { std::size_t(1), std::size_t(100), std::size_t(n) }){
+            auto policy = parallel::par.with_threads(n_threads).with_grain(grain);
+
+            // every element is visited once, in increasing order inside a chunk
+            std::vector<std::atomic<int> > visits(n);
+            std::atomic<int> n_unordered(0);
+            parallel::for_range(policy, s.begin(), s.end(), [&](std::set<int>::const_iterator b, std::set<int>::const_iterator e){
+                int previous = -1;
+                for(; b != e; ++b){
+                    visits[*b]++;
+                    if(*b != previous + 1 && previous != -1){
+                        n_unordered++;
+                    }
+                    previous = *b;
+                }
+            });
+
+            BOOST_CHECK(std::all_of(visits.begin(), visits.end(), [](const std::atomic<int> & v){ return v.load() == 1; }));
+            BOOST_CHECK_EQUAL(n_unordered.load(), 0);
+
+            BOOST_CHECK_EQUAL(parallel::count_if(policy, l.begin(), l.end(), [](int v){ return v % 3 == 0; }), (n + 2) / 3);
+            BOOST_CHECK_EQUAL(parallel::reduce(policy, s.begin(), s.end(), 0L), long(n) * (n - 1) / 2);
+
+            // non commutative reduction, the chunks are combined in order
+            const std::string concat_ref = std::accumulate(words.begin(), words.end(), std::string());
+            BOOST_CHECK_EQUAL(parallel::reduce(policy, words.begin(), words.end(), std::string()), concat_ref);
+
+            BOOST_CHECK(parallel::all_of(policy, l.begin(), l.end(), [](int v){ return v < n; }));
+            BOOST_CHECK(parallel::none_of(policy, s.begin(), s.end(), [](int v){ return v < 0; }));
+        }
+    }
+
+    // empty ranges
+    std::list<int> empty;
+    BOOST_CHECK_EQUAL(parallel::reduce(parallel::par.with_threads(4), empty.begin(), empty.end(), 42), 42);
+    BOOST_CHECK_EQUAL(parallel::count(parallel::par.with_threads(4), empty.begin(), empty.end(), 1), 0);
+}
+
+
+BOOST_AUTO_TEST_CASE( parallel_find_test)
+{
+    using namespace hadoken;
+
+    const std::size_t n = 100000;
+    std::vector<int> values(n);
+    std::iota(values.begin(), values.end(), 0);
+    std::list<int> l(values.begin(), values.end());
+
+    for(std::size_t n_threads : { std::size_t(1), std::size_t(3), std::size_t(8) }){
+        auto policy = parallel::par.with_threads(n_threads);
+        auto policy_dynamic = parallel::par_vec.with_threads(n_threads).with_schedule(parallel::schedule_type::dynamic);
+
+        for(int target : { 0, 1, 1023, 1024, 33333, 77777, int(n) - 1 }){
+            // every multiple of target matches, the lowest one is returned
+            auto multiple = [target](int v){ return v >= target && (target == 0 || v % target == 0); };
+
+            BOOST_CHECK(parallel::find_if(policy, values.begin(), values.end(), multiple) == values.begin() + target);
+            BOOST_CHECK(parallel::find_if(policy_dynamic, values.begin(), values.end(), multiple) == values.begin() + target);
+            BOOST_CHECK(parallel::find(policy, values.begin(), values.end(), target) == values.begin() + target);
+
+            auto it = parallel::find_if(policy, l.begin(), l.end(), multiple);
+            BOOST_CHECK(it != l.end() && *it == target);
+
+            BOOST_CHECK(parallel::find_if_not(policy, values.begin(), values.end(), [target](int v){ return v < target; })
+                        == values.begin() + target);
+        }
+
+        BOOST_CHECK(parallel::find(policy, values.begin(), values.end(), -1) == values.end());
+        BOOST_CHECK(parallel::find(policy, l.begin(), l.end(), int(n)) == l.end());
+        BOOST_CHECK(parallel::find(policy, values.begin(), values.begin(), 0) == values.begin());
+
+        BOOST_CHECK(parallel::any_of(policy, l.begin(), l.end(), [](int v){ return v == 4242; }));
+        BOOST_CHECK(parallel::all_of(policy, l.begin(), l.end(), [](int v){ return v >= 0; }));
+        BOOST_CHECK(parallel::none_of(policy, l.begin(), l.end(), [](int v){ return v == 4242; }) == false);
+    }
+
+    // a match cancels the search after it, and only after it for find
+    {
+        parallel::detail::find_state<true, std::vector<int>::iterator> first_match(values.end());
+        first_match.found(5000, values.begin() + 5000);
+        first_match.found(7000, values.begin() + 7000);
+
+        BOOST_CHECK(first_match.cancelled(4999) == false);
+        BOOST_CHECK(first_match.cancelled(5000));
+        BOOST_CHECK(first_match.result() == values.begin() + 5000);
+
+        std::size_t n_evaluations = 0;
+        auto counting = [&n_evaluations](int v){ n_evaluations++; return v >= 0; };
+        parallel::detail::_find_in_chunk(first_match, values.begin() + 6000, values.end(), 6000, counting);
+        BOOST_CHECK_EQUAL(n_evaluations, 0u);
+
+        parallel::detail::find_state<false, std::vector<int>::iterator> any_match(values.end());
+        any_match.found(5000, values.begin() + 5000);
+        BOOST_CHECK(any_match.cancelled(0));
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( parallel_transform_unary_test)
+{
+    using namespace hadoken;
+
+    static_assert(parallel::detail::is_contiguous_iterator<double*>::value, "pointer is contiguous");
+    static_assert(parallel::detail::is_contiguous_iterator<std::vector<int>::const_iterator>::value, "vector is contiguous");
+    static_assert(parallel::detail::is_contiguous_iterator<std::vector<bool>::iterator>::value == false, "vector<bool> is not contiguous");
+    static_assert(parallel::detail::is_contiguous_iterator<std::list<int>::iterator>::value == false, "list is not contiguous");
+    static_assert(parallel::detail::is_contiguous_iterator<std::back_insert_iterator<std::vector<int> > >::value == false,
+                  "output iterator is not contiguous");
+
+    const std::size_t n = 10007;
+    std::vector<float> in(n + 3);
+    std::iota(in.begin(), in.end(), 0.0f);
+
+    auto op = [](float v){ return v * 2.0f + 1.0f; };
+
+    std::vector<float> ref(n + 3);
+    std::transform(in.begin(), in.end(), ref.begin(), op);
+
+    for(std::size_t n_threads : { std::size_t(1), std::size_t(3) }){
+        auto policy = parallel::par_vec.with_threads(n_threads);
+
+        // disjoint, aligned or not
+        for(std::size_t shift : { std::size_t(0), std::size_t(1), std::size_t(3) }){
+            std::vector<float> out(n + 3, -1.0f);
+            float* res = parallel::transform(policy, in.data() + shift, in.data() + n, out.data() + shift, op);
+            BOOST_CHECK(res == out.data() + n);
+            BOOST_CHECK(std::equal(out.begin() + shift, out.begin() + n, ref.begin() + shift));
+            BOOST_CHECK(std::all_of(out.begin(), out.begin() + shift, [](float v){ return v == -1.0f; }));
+        }
+
+        // in place
+        std::vector<float> in_place(in);
+        parallel::transform(policy, in_place.begin(), in_place.end(), in_place.begin(), op);
+        BOOST_CHECK(in_place == ref);
+
+        // conversion
+        std::vector<double> converted(n);
+        parallel::transform(policy, in.begin(), in.begin() + n, converted.begin(), [](float v){ return double(v) / 2.0; });
+        for(std::size_t i = 0; i < n; ++i){
+            BOOST_CHECK_EQUAL(converted[i], double(in[i]) / 2.0);
+        }
+
+        // non contiguous output
+        std::list<float> l(n);
+        parallel::transform(policy, in.begin(), in.begin() + n, l.begin(), op);
+        BOOST_CHECK(std::equal(l.begin(), l.end(), ref.begin()));
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( parallel_minmax_element_test)
+{
+    using namespace hadoken;
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(-50, 50);
+
+    for(std::size_t n : { std::size_t(0), std::size_t(1), std::size_t(7), std::size_t(100), std::size_t(100003) }){
+        // many duplicates: the position rules are exercised
+        std::vector<int> values(n);
+        for(auto & v : values){
+            v = dist(gen);
+        }
+        std::vector<double> doubles(values.begin(), values.end());
+        std::list<int> l(values.begin(), values.end());
+
+        for(std::size_t n_threads : { std::size_t(1), std::size_t(3), std::size_t(8) }){
+            auto par = parallel::par.with_threads(n_threads);
+            auto par_vec = parallel::par_vec.with_threads(n_threads).with_grain(10);
+
+            BOOST_CHECK(parallel::min_element(par, values.begin(), values.end()) == std::min_element(values.begin(), values.end()));
+            BOOST_CHECK(parallel::min_element(par_vec, values.begin(), values.end()) == std::min_element(values.begin(), values.end()));
+            BOOST_CHECK(parallel::max_element(par, values.begin(), values.end()) == std::max_element(values.begin(), values.end()));
+            BOOST_CHECK(parallel::max_element(par_vec, doubles.begin(), doubles.end()) == std::max_element(doubles.begin(), doubles.end()));
+            BOOST_CHECK(parallel::minmax_element(par, values.begin(), values.end()) == std::minmax_element(values.begin(), values.end()));
+            BOOST_CHECK(parallel::minmax_element(par_vec, doubles.begin(), doubles.end()) == std::minmax_element(doubles.begin(), doubles.end()));
+            BOOST_CHECK(parallel::minmax_element(par_vec, values.data(), values.data() + n) == std::minmax_element(values.data(), values.data() + n));
+
+            // custom comparator and non random access iterators
+            auto abs_less = [](int a, int b){ return std::abs(a) < std::abs(b); };
+            BOOST_CHECK(parallel::min_element(par, l.begin(), l.end(), abs_less) == std::min_element(l.begin(), l.end(), abs_less));
+            BOOST_CHECK(parallel::minmax_element(par_vec, l.begin(), l.end(), abs_less) == std::minmax_element(l.begin(), l.end(), abs_less));
+            BOOST_CHECK(parallel::max_element(par_vec, values.begin(), values.end(), abs_less)
+                        == std::max_element(values.begin(), values.end(), abs_less));
+        }
+
+        BOOST_CHECK(parallel::minmax_element(parallel::seq, values.begin(), values.end()) == std::minmax_element(values.begin(), values.end()));
+    }
+
+    // NaN are not ordered, the result is unspecified but stays in the range
+    std::vector<double> with_nan(1000, 1.0);
+    with_nan[0] = std::numeric_limits<double>::quiet_NaN();
+    with_nan[500] = -1.0;
+    auto res = parallel::minmax_element(parallel::par_vec.with_threads(3), with_nan.begin(), with_nan.end());
+    BOOST_CHECK(res.first >= with_nan.begin() && res.first < with_nan.end());
+    BOOST_CHECK(res.second >= with_nan.begin() && res.second < with_nan.end());
+
+    // a NaN in a vector lane does not hide the following elements of the lane
+    std::vector<double> lane_nan(1000, 1.0);
+    lane_nan[1] = std::numeric_limits<double>::quiet_NaN();
+    lane_nan[41] = -100.0;
+    lane_nan[57] = 500.0;
+    for(std::size_t n_threads : { std::size_t(1), std::size_t(3) }){
+        auto policy = parallel::par_vec.with_threads(n_threads);
+        BOOST_CHECK_EQUAL(parallel::min_element(policy, lane_nan.begin(), lane_nan.end()) - lane_nan.begin(), 41);
+        BOOST_CHECK_EQUAL(parallel::max_element(policy, lane_nan.begin(), lane_nan.end()) - lane_nan.begin(), 57);
+        auto nan_res = parallel::minmax_element(policy, lane_nan.begin(), lane_nan.end());
+        BOOST_CHECK_EQUAL(nan_res.first - lane_nan.begin(), 41);
+        BOOST_CHECK_EQUAL(nan_res.second - lane_nan.begin(), 57);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( parallel_compaction_test)
+{
+    using namespace hadoken;
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(0, 20);
+
+    auto is_even = [](int v){ return v % 2 == 0; };
+
+    for(std::size_t n : { std::size_t(0), std::size_t(1), std::size_t(7), std::size_t(100), std::size_t(100003) }){
+        // short runs of duplicates for unique
+        std::vector<int> values(n);
+        for(auto & v : values){
+            v = dist(gen) / 4;
+        }
+
+        std::vector<int> ref_copy;
+        std::copy_if(values.begin(), values.end(), std::back_inserter(ref_copy), is_even);
+
+        std::vector<int> ref_removed(values);
+        ref_removed.erase(std::remove_if(ref_removed.begin(), ref_removed.end(), is_even), ref_removed.end());
+
+        std::vector<int> ref_stable(values);
+        const std::size_t ref_n_even = static_cast<std::size_t>(
+                    std::stable_partition(ref_stable.begin(), ref_stable.end(), is_even) - ref_stable.begin());
+
+        std::vector<int> ref_unique(values);
+        ref_unique.erase(std::unique(ref_unique.begin(), ref_unique.end()), ref_unique.end());
+
+        for(std::size_t n_threads : { std::size_t(1), std::size_t(3), std::size_t(8) }){
+            auto policy = parallel::par.with_threads(n_threads);
+
+            std::vector<int> copied(n, -1);
+            auto copied_end = parallel::copy_if(policy, values.begin(), values.end(), copied.begin(), is_even);
+            BOOST_CHECK(std::vector<int>(copied.begin(), copied_end) == ref_copy);
+            BOOST_CHECK(std::all_of(copied_end, copied.end(), [](int v){ return v == -1; }));
+
+            std::vector<int> removed(values);
+            removed.erase(parallel::remove_if(policy, removed.begin(), removed.end(), is_even), removed.end());
+            BOOST_CHECK(removed == ref_removed);
+
+            std::vector<int> stable(values);
+            auto stable_mid = parallel::stable_partition(policy, stable.begin(), stable.end(), is_even);
+            BOOST_CHECK_EQUAL(static_cast<std::size_t>(stable_mid - stable.begin()), ref_n_even);
+            BOOST_CHECK(stable == ref_stable);
+
+            std::vector<int> partitioned(values);
+            auto mid = parallel::partition(parallel::par_vec.with_threads(n_threads), partitioned.begin(), partitioned.end(), is_even);
+            BOOST_CHECK_EQUAL(static_cast<std::size_t>(mid - partitioned.begin()), ref_n_even);
+            BOOST_CHECK(std::is_partitioned(partitioned.begin(), partitioned.end(), is_even));
+            BOOST_CHECK(std::is_permutation(partitioned.begin(), partitioned.end(), values.begin()));
+
+            std::vector<int> uniq(values);
+            uniq.erase(parallel::unique(policy, uniq.begin(), uniq.end()), uniq.end());
+            BOOST_CHECK(uniq == ref_unique);
+        }
+
+        // non random access iterators, sequential
+        std::list<int> l(values.begin(), values.end());
+        l.erase(parallel::remove_if(parallel::par, l.begin(), l.end(), is_even), l.end());
+        BOOST_CHECK(std::vector<int>(l.begin(), l.end()) == ref_removed);
+
+        std::list<int> copied_list;
+        parallel::copy_if(parallel::par, values.begin(), values.end(), std::back_inserter(copied_list), is_even);
+        BOOST_CHECK(std::vector<int>(copied_list.begin(), copied_list.end()) == ref_copy);
+    }
+
+    // move only elements
+    std::vector<std::unique_ptr<int> > ptrs;
+    for(int i = 0; i < 1000; ++i){
+        ptrs.emplace_back(new int(i));
+    }
+    auto mid = parallel::stable_partition(parallel::par.with_threads(4), ptrs.begin(), ptrs.end(),
+                                          [](const std::unique_ptr<int> & p){ return *p % 3 == 0; });
+    BOOST_CHECK_EQUAL(mid - ptrs.begin(), 334);
+    BOOST_CHECK(std::is_sorted(ptrs.begin(), mid, [](const std::unique_ptr<int> & a, const std::unique_ptr<int> & b){ return *a < *b; }));
+    auto removed_end = parallel::remove_if(parallel::par.with_threads(4), ptrs.begin(), ptrs.end(),
+                                           [](const std::unique_ptr<int> & p){ return *p % 2 == 0; });
+    BOOST_CHECK_EQUAL(removed_end - ptrs.begin(), 500);
+}
+
+
+template<typename Key, typename Distribution>
+void check_radix_sort(Distribution dist, std::size_t n){
+    using namespace hadoken;
+
+    std::mt19937 gen(42);
+    std::vector<Key> keys(n);
+    for(auto & k : keys){
+        k = static_cast<Key>(dist(gen));
+    }
+
+    std::vector<Key> ref(keys);
+    std::sort(ref.begin(), ref.end());
+
+    for(std::size_t n_threads : { std::size_t(1), std::size_t(3), std::size_t(8) }){
+        std::vector<Key> sorted(keys);
+        parallel::radix_sort(parallel::par.with_threads(n_threads).with_grain(1000), sorted.begin(), sorted.end());
+        BOOST_CHECK(sorted == ref);
+    }
+
+    std::vector<Key> sorted(keys);
+    parallel::radix_sort(parallel::seq, sorted.data(), sorted.data() + n);
+    BOOST_CHECK(sorted == ref);
+}
+
+
+BOOST_AUTO_TEST_CASE( parallel_radix_sort_test)
+{
+    using namespace hadoken;
+
+    for(std::size_t n : { std::size_t(0), std::size_t(1), std::size_t(7), std::size_t(1000), std::size_t(100003) }){
+        check_radix_sort<std::uint32_t>(std::uniform_int_distribution<std::uint32_t>(), n);
+        // small keys in a large type: the upper passes are skipped
+        check_radix_sort<std::uint64_t>(std::uniform_int_distribution<std::uint64_t>(0, 100000), n);
+        check_radix_sort<std::uint64_t>(std::uniform_int_distribution<std::uint64_t>(), n);
+        check_radix_sort<int>(std::uniform_int_distribution<int>(std::numeric_limits<int>::min(), std::numeric_limits<int>::max()), n);
+        check_radix_sort<std::int16_t>(std::uniform_int_distribution<int>(-300, 300), n);
+        check_radix_sort<float>(std::uniform_real_distribution<float>(-1e6f, 1e6f), n);
+        check_radix_sort<double>(std::normal_distribution<double>(0, 1e3), n);
+        // all keys equal
+        check_radix_sort<std::uint32_t>(std::uniform_int_distribution<std::uint32_t>(7, 7), n);
+    }
+
+    // floating point special values
+    std::vector<double> specials = { 3.0, -0.0, std::numeric_limits<double>::infinity(), 0.0, -2.5,
+                                     -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::denorm_min(), -1e300 };
+    std::vector<double> big;
+    for(int i = 0; i < 5000; ++i){
+        big.insert(big.end(), specials.begin(), specials.end());
+    }
+    parallel::radix_sort(parallel::par.with_threads(4).with_grain(1000), big.begin(), big.end());
+    BOOST_CHECK(std::is_sorted(big.begin(), big.end()));
+    BOOST_CHECK(std::signbit(big[5000 * 3]) && big[5000 * 3] == 0.0);
+    BOOST_CHECK(!std::signbit(big[5000 * 4]) && big[5000 * 4] == 0.0);
+}
+
+
+BOOST_AUTO_TEST_CASE( parallel_sort_by_key_test)
+{
+    using namespace hadoken;
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(-1000, 1000);
+
+    for(std::size_t n : { std::size_t(0), std::size_t(1), std::size_t(7), std::size_t(1000), std::size_t(100003) }){
+        // many duplicated keys, the values are the original positions
+        std::vector<int> keys(n);
+        for(auto & k : keys){
+            k = dist(gen);
+        }
+        std::vector<std::size_t> ref_order(n);
+        std::iota(ref_order.begin(), ref_order.end(), 0);
+        std::stable_sort(ref_order.begin(), ref_order.end(), [&](std::size_t a, std::size_t b){ return keys[a] < keys[b]; });
+
+        for(std::size_t n_threads : { std::size_t(1), std::size_t(3), std::size_t(8) }){
+            std::vector<int> sorted_keys(keys);
+            std::vector<std::size_t> values(n);
+            std::iota(values.begin(), values.end(), 0);
+
+            parallel::sort_by_key(parallel::par.with_threads(n_threads).with_grain(1000), sorted_keys.begin(), sorted_keys.end(), values.begin());
+
+            BOOST_CHECK(values == ref_order);
+            BOOST_CHECK(std::is_sorted(sorted_keys.begin(), sorted_keys.end()));
+        }
+    }
+
+    // non trivial values
+    std::vector<float> keys = { 2.0f, -1.0f, 2.0f, 0.5f };
+    std::vector<std::string> values = { "a", "b", "c", "d" };
+    parallel::sort_by_key(parallel::par, keys.begin(), keys.end(), values.begin());
+    BOOST_CHECK(values == std::vector<std::string>({ "b", "d", "a", "c" }));
+}
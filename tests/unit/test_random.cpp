@@ -35,6 +35,11 @@
 
 
 #include <boost/random.hpp>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
 
 #include <hadoken/random/random.hpp>
 
@@ -81,6 +86,85 @@ BOOST_AUTO_TEST_CASE( simple_random_tests )
 
 
 
+BOOST_AUTO_TEST_CASE( mapper_buffered_stream )
+{
+    const std::size_t n_vals = 1000;
+
+    boost::random::mt19937 twister_engine;
+    hadoken::random_engine_mapper_32 twister_mapper(twister_engine);
+
+    hadoken::counter_engine<hadoken::threefry4x64> threefry_engine;
+    hadoken::random_engine_mapper_64 threefry_mapper(threefry_engine);
+
+    // the buffered mapper returns the stream of the mapped engine
+    for(std::size_t i = 0; i < n_vals; ++i){
+        BOOST_CHECK_EQUAL(twister_mapper(), twister_engine());
+        BOOST_CHECK_EQUAL(threefry_mapper(), threefry_engine());
+    }
+
+    // copies in the middle of a buffered block continue the same stream
+    (void) twister_mapper();
+    hadoken::random_engine_mapper_32 twister_mapper_copy(twister_mapper);
+    for(std::size_t i = 0; i < n_vals; ++i){
+        BOOST_CHECK_EQUAL(twister_mapper(), twister_mapper_copy());
+    }
+
+    // seed drops the buffered values
+    twister_mapper.seed(42);
+    twister_engine.seed(42);
+    for(std::size_t i = 0; i < n_vals; ++i){
+        BOOST_CHECK_EQUAL(twister_mapper(), twister_engine());
+    }
+
+    // derivation is deterministic and depends of the consumed position
+    hadoken::random_engine_mapper_32 derivated = twister_mapper.derivate(42);
+    hadoken::random_engine_mapper_32 derivated_same = twister_mapper.derivate(42);
+    (void) twister_mapper();
+    hadoken::random_engine_mapper_32 derivated_next = twister_mapper.derivate(42);
+
+    const boost::uint32_t v = derivated();
+    BOOST_CHECK_EQUAL(v, derivated_same());
+    BOOST_CHECK_NE(v, derivated_next());
+}
+
+
+
+template<typename Engine>
+void check_mapper_derivate(){
+    Engine engine;
+    hadoken::random_engine_mapper_32 mapper(engine);
+
+    // a derivation in the middle of a buffered block, at its end, or in the next one
+    // is the derivation of the mapped engine at the same position
+    for(std::size_t n_draws : { std::size_t(10), std::size_t(54), std::size_t(1) }){
+        for(std::size_t i = 0; i < n_draws; ++i){
+            BOOST_CHECK_EQUAL(mapper(), engine());
+        }
+
+        hadoken::random_engine_mapper_32 derivated_mapper = hadoken::random_engine_derivate(mapper, 42);
+        Engine derivated = hadoken::random_engine_derivate(engine, 42);
+
+        hadoken::random_engine_mapper_32 derivated_threefry_mapper = hadoken::random_engine_derivate(mapper, 42, hadoken::derivate_threefry_policy());
+        Engine derivated_threefry = hadoken::random_engine_derivate(engine, 42, hadoken::derivate_threefry_policy());
+
+        for(std::size_t i = 0; i < 100; ++i){
+            BOOST_CHECK_EQUAL(derivated_mapper(), derivated());
+            BOOST_CHECK_EQUAL(derivated_threefry_mapper(), derivated_threefry());
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( mapper_buffered_derivate )
+{
+    // large state, called directly
+    check_mapper_derivate<boost::random::mt19937>();
+    // small state, buffered by blocks
+    check_mapper_derivate<hadoken::counter_engine<hadoken::threefry4x32> >();
+}
+
+
+
 BOOST_AUTO_TEST_CASE( simple_derivate)
 {
     const std::size_t n_vals = 1000;
@@ -179,6 +263,114 @@ BOOST_AUTO_TEST_CASE( determinism_derivate)
 
 
 
+namespace {
+
+double correlation(const std::vector<double> & x, const std::vector<double> & y){
+    const double n = double(x.size());
+    const double mean_x = std::accumulate(x.begin(), x.end(), 0.0) / n;
+    const double mean_y = std::accumulate(y.begin(), y.end(), 0.0) / n;
+
+    double cov = 0, var_x = 0, var_y = 0;
+    for(std::size_t i = 0; i < x.size(); ++i){
+        cov += (x[i] - mean_x) * (y[i] - mean_y);
+        var_x += (x[i] - mean_x) * (x[i] - mean_x);
+        var_y += (y[i] - mean_y) * (y[i] - mean_y);
+    }
+    return cov / std::sqrt(var_x * var_y);
+}
+
+}
+
+
+BOOST_AUTO_TEST_CASE( derivate_threefry_policy_statistics)
+{
+    const std::size_t n_streams = 20000;
+    const std::size_t n_buckets = 64;
+
+    boost::random::mt19937 twister_engine;
+    twister_engine.seed(1234);
+
+    // determinism
+    {
+        boost::random::mt19937 derivated = hadoken::random_engine_derivate(twister_engine, 42, hadoken::derivate_threefry_policy());
+        boost::random::mt19937 derivated_same = hadoken::random_engine_derivate(twister_engine, 42, hadoken::derivate_threefry_policy());
+        boost::random::mt19937 derivated_sha1 = hadoken::random_engine_derivate(twister_engine, 42, hadoken::derivate_sha1_policy());
+        boost::random::mt19937 derivated_default = hadoken::random_engine_derivate(twister_engine, 42);
+
+        BOOST_CHECK(derivated == derivated_same);
+        BOOST_CHECK(derivated != derivated_sha1);
+        BOOST_CHECK(derivated_default == derivated_sha1);
+    }
+
+    // first value of the streams derivated with consecutive keys
+    std::vector<boost::uint32_t> first_values;
+    std::vector<std::uint64_t> first_pairs;
+    for(std::size_t key = 0; key < n_streams; ++key){
+        boost::random::mt19937 derivated = hadoken::random_engine_derivate(twister_engine, static_cast<boost::uint32_t>(key), hadoken::derivate_threefry_policy());
+        const boost::uint32_t v1 = derivated(), v2 = derivated();
+        first_values.push_back(v1);
+        first_pairs.push_back((std::uint64_t(v1) << 32) | v2);
+    }
+
+    // no stream collision
+    std::sort(first_pairs.begin(), first_pairs.end());
+    BOOST_CHECK(std::adjacent_find(first_pairs.begin(), first_pairs.end()) == first_pairs.end());
+
+    // uniformity: chi-square on the high bits, 63 degrees of freedom
+    std::vector<double> buckets(n_buckets, 0);
+    for(boost::uint32_t v : first_values){
+        buckets[v >> 26] += 1;
+    }
+    const double expected = double(n_streams) / n_buckets;
+    double chi2 = 0;
+    for(double b : buckets){
+        chi2 += (b - expected) * (b - expected) / expected;
+    }
+    std::cout << "derivate_threefry_chi2: " << chi2 << "\n";
+    BOOST_CHECK_LT(chi2, 120.0);
+
+    // bit balance
+    for(int bit = 0; bit < 32; ++bit){
+        std::size_t ones = 0;
+        for(boost::uint32_t v : first_values){
+            ones += (v >> bit) & 0x01;
+        }
+        BOOST_CHECK_LT(std::abs(double(ones) - n_streams / 2.0), 5 * std::sqrt(n_streams / 4.0));
+    }
+
+    // no correlation between streams of consecutive keys
+    std::vector<double> x(first_values.begin(), first_values.end() - 1), y(first_values.begin() + 1, first_values.end());
+    const double serial = correlation(x, y);
+    std::cout << "derivate_threefry_serial_correlation: " << serial << "\n";
+    BOOST_CHECK_LT(std::abs(serial), 5.0 / std::sqrt(double(n_streams)));
+
+    // no correlation between the parent and a derivated stream
+    {
+        boost::random::mt19937 parent(twister_engine);
+        boost::random::mt19937 derivated = hadoken::random_engine_derivate(twister_engine, 1, hadoken::derivate_threefry_policy());
+
+        std::vector<double> parent_values, derivated_values;
+        for(std::size_t i = 0; i < n_streams; ++i){
+            parent_values.push_back(parent());
+            derivated_values.push_back(derivated());
+        }
+        BOOST_CHECK_LT(std::abs(correlation(parent_values, derivated_values)), 5.0 / std::sqrt(double(n_streams)));
+    }
+
+    // mapper follows the same policy
+    {
+        hadoken::random_engine_mapper_32 mapper(twister_engine);
+        hadoken::random_engine_mapper_32 derivated_mapper = hadoken::random_engine_derivate(mapper, 42, hadoken::derivate_threefry_policy());
+        boost::random::mt19937 derivated = hadoken::random_engine_derivate(twister_engine, 42, hadoken::derivate_threefry_policy());
+
+        for(std::size_t i = 0; i < 100; ++i){
+            BOOST_CHECK_EQUAL(derivated_mapper(), derivated());
+        }
+    }
+}
+
+
+
 BOOST_AUTO_TEST_CASE( derivate_counter_based_determinism)
 {
     const std::size_t n_vals = 1000;
@@ -329,6 +521,15 @@ typedef boost::mpl::list<hadoken::threefry2x32,
                         hadoken::threefry2x64,
                         hadoken::threefry4x64> threefry_types;
 
+typedef boost::mpl::list<hadoken::threefry2x32,
+                        hadoken::threefry4x32,
+                        hadoken::threefry2x64,
+                        hadoken::threefry4x64,
+                        hadoken::philox2x32,
+                        hadoken::philox4x32,
+                        hadoken::philox2x64,
+                        hadoken::philox4x64> cbrng_types;
+
 BOOST_AUTO_TEST_CASE_TEMPLATE( threefry_distribute, T, threefry_types )
 {
         boost::random::uniform_int_distribution<boost::uint64_t> dist100(0, 100);
@@ -350,6 +551,210 @@ BOOST_AUTO_TEST_CASE_TEMPLATE( threefry_distribute, T, threefry_types )
 
 
 
+// known answer tests from the Random123 distribution ( kat_vectors )
+BOOST_AUTO_TEST_CASE( philox_known_answer )
+{
+    {
+        hadoken::philox2x32 cipher;
+        hadoken::philox2x32::range_type res, expected;
+
+        res = cipher({ { 0, 0 } });
+        expected = { { 0xff1dae59, 0x6cd10df2 } };
+        BOOST_CHECK(res == expected);
+
+        cipher.set_key({ { 0xffffffff } });
+        res = cipher({ { 0xffffffff, 0xffffffff } });
+        expected = { { 0x2c3f628b, 0xab4fd7ad } };
+        BOOST_CHECK(res == expected);
+
+        cipher.set_key({ { 0x13198a2e } });
+        res = cipher({ { 0x243f6a88, 0x85a308d3 } });
+        expected = { { 0xdd7ce038, 0xf62a4c12 } };
+        BOOST_CHECK(res == expected);
+    }
+
+    {
+        hadoken::philox4x32 cipher;
+        hadoken::philox4x32::range_type res, expected;
+
+        res = cipher({ { 0, 0, 0, 0 } });
+        expected = { { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 } };
+        BOOST_CHECK(res == expected);
+
+        cipher.set_key({ { 0xffffffff, 0xffffffff } });
+        res = cipher({ { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff } });
+        expected = { { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd } };
+        BOOST_CHECK(res == expected);
+
+        cipher.set_key({ { 0xa4093822, 0x299f31d0 } });
+        res = cipher({ { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 } });
+        expected = { { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 } };
+        BOOST_CHECK(res == expected);
+    }
+
+    {
+        hadoken::philox2x64 cipher;
+        hadoken::philox2x64::range_type res, expected;
+
+        res = cipher({ { 0, 0 } });
+        expected = { { 0xca00a0459843d731ULL, 0x66c24222c9a845b5ULL } };
+        BOOST_CHECK(res == expected);
+
+        cipher.set_key({ { 0xffffffffffffffffULL } });
+        res = cipher({ { 0xffffffffffffffffULL, 0xffffffffffffffffULL } });
+        expected = { { 0x65b021d60cd8310fULL, 0x4d02f3222f86df20ULL } };
+        BOOST_CHECK(res == expected);
+
+        cipher.set_key({ { 0xa4093822299f31d0ULL } });
+        res = cipher({ { 0x243f6a8885a308d3ULL, 0x13198a2e03707344ULL } });
+        expected = { { 0x0a5e742c2997341cULL, 0xb0f883d38000de5dULL } };
+        BOOST_CHECK(res == expected);
+    }
+
+    {
+        hadoken::philox4x64 cipher;
+        hadoken::philox4x64::range_type res, expected;
+
+        res = cipher({ { 0, 0, 0, 0 } });
+        expected = { { 0x16554d9eca36314cULL, 0xdb20fe9d672d0fdcULL, 0xd7e772cee186176bULL, 0x7e68b68aec7ba23bULL } };
+        BOOST_CHECK(res == expected);
+
+        cipher.set_key({ { 0xffffffffffffffffULL, 0xffffffffffffffffULL } });
+        res = cipher({ { 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL } });
+        expected = { { 0x87b092c3013fe90bULL, 0x438c3c67be8d0224ULL, 0x9cc7d7c69cd777b6ULL, 0xa09caebf594f0ba0ULL } };
+        BOOST_CHECK(res == expected);
+
+        cipher.set_key({ { 0x452821e638d01377ULL, 0xbe5466cf34e90c6cULL } });
+        res = cipher({ { 0x243f6a8885a308d3ULL, 0x13198a2e03707344ULL, 0xa4093822299f31d0ULL, 0x082efa98ec4e6c89ULL } });
+        expected = { { 0xa528f45403e61d95ULL, 0x38c72dbd566e9788ULL, 0xa5a1610e72fd18b5ULL, 0x57bd43b5e52b7fe6ULL } };
+        BOOST_CHECK(res == expected);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( cbrng_engine_basic, T, cbrng_types )
+{
+    boost::random::uniform_int_distribution<boost::uint64_t> dist100(0, 100);
+
+    hadoken::counter_engine<T> engine(42), engine_clone(42);
+
+    const std::size_t n_normalize = 100000;
+    std::size_t res = 0;
+    for(std::size_t i =0; i < n_normalize; ++i){
+        res += dist100(engine);
+    }
+
+    const std::size_t mean = res/n_normalize;
+    BOOST_CHECK_GE(mean, 49);
+    BOOST_CHECK_LE(mean, 51);
+
+    // discard and derivate work whatever the key size
+    engine_clone.discard(engine.getcounter()[0] * engine.getcounter().size());
+    BOOST_CHECK(engine.getcounter() == engine_clone.getcounter());
+
+    hadoken::counter_engine<T> derivated = engine.derivate(7), derivated_same = engine.derivate(7);
+    BOOST_CHECK_EQUAL(derivated(), derivated_same());
+    BOOST_CHECK_NE(derivated(), engine());
+}
+
+
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( cbrng_batch, T, cbrng_types )
+{
+    typedef typename T::domain_type domain_type;
+    typedef typename T::range_type range_type;
+
+    typename T::key_type key;
+    for(std::size_t w = 0; w < key.size(); ++w){
+        key[w] = static_cast<typename T::uint_type>(0x9E3779B97F4A7C15ULL * (w + 1));
+    }
+
+    T cipher(key);
+
+    // not a multiple of the number of lanes to cover the scalar remainder
+    const std::size_t n_blocks = 1003;
+
+    std::vector<domain_type> counters(n_blocks);
+    for(std::size_t i = 0; i < n_blocks; ++i){
+        for(std::size_t w = 0; w < counters[i].size(); ++w){
+            counters[i][w] = static_cast<typename T::uint_type>(i * 7919 + w * 104729 + (i >> 3));
+        }
+    }
+
+    std::vector<range_type> res_default(n_blocks), res_sse(n_blocks), res_avx512(n_blocks);
+
+    cipher.batch(counters.data(), n_blocks, res_default.data());
+    cipher.template batch<4>(counters.data(), n_blocks, res_sse.data());
+    cipher.template batch<16>(counters.data(), n_blocks, res_avx512.data());
+
+    for(std::size_t i = 0; i < n_blocks; ++i){
+        const range_type ref = cipher(counters[i]);
+
+        BOOST_CHECK(res_default[i] == ref);
+        BOOST_CHECK(res_sse[i] == ref);
+        BOOST_CHECK(res_avx512[i] == ref);
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( engine_bulk_generate, T, cbrng_types )
+{
+    typedef typename hadoken::counter_engine<T>::result_type result_type;
+
+    // sizes around the block size and the internal batch size
+    const std::size_t sizes[] = { 0, 1, 3, 4, 5, 17, 255, 256, 257, 1000, 5003 };
+
+    for(std::size_t offset = 0; offset < 5; ++offset){
+        for(std::size_t n : sizes){
+            hadoken::counter_engine<T> engine_bulk(42), engine_seq(42);
+
+            // start in the middle of a buffered block
+            for(std::size_t i = 0; i < offset; ++i){
+                BOOST_CHECK_EQUAL(engine_bulk(), engine_seq());
+            }
+
+            std::vector<result_type> bulk(n), seq(n);
+            engine_bulk.generate(bulk.begin(), bulk.end());
+            std::generate(seq.begin(), seq.end(), std::ref(engine_seq));
+
+            BOOST_CHECK_EQUAL_COLLECTIONS(bulk.begin(), bulk.end(), seq.begin(), seq.end());
+            BOOST_CHECK(engine_bulk == engine_seq);
+
+            // the stream continues identically
+            for(std::size_t i = 0; i < 7; ++i){
+                BOOST_CHECK_EQUAL(engine_bulk(), engine_seq());
+            }
+
+            engine_bulk.fill(bulk.data(), bulk.size());
+            std::generate(seq.begin(), seq.end(), std::ref(engine_seq));
+
+            BOOST_CHECK_EQUAL_COLLECTIONS(bulk.begin(), bulk.end(), seq.begin(), seq.end());
+            BOOST_CHECK_EQUAL(engine_bulk(), engine_seq());
+        }
+    }
+
+    // carry propagation on the counter during a bulk generation
+    if(sizeof(typename T::uint_type) < sizeof(std::uintmax_t)){
+        hadoken::counter_engine<T> engine_bulk(42), engine_seq(42);
+        const std::uintmax_t n_block_values = engine_seq.getcounter().size();
+        const std::uintmax_t max_word = std::numeric_limits<typename T::uint_type>::max();
+
+        engine_bulk.discard((max_word - 10) * n_block_values);
+        engine_seq.discard((max_word - 10) * n_block_values);
+
+        std::vector<result_type> bulk(1000), seq(1000);
+        engine_bulk.generate(bulk.begin(), bulk.end());
+        std::generate(seq.begin(), seq.end(), std::ref(engine_seq));
+
+        BOOST_CHECK_EQUAL_COLLECTIONS(bulk.begin(), bulk.end(), seq.begin(), seq.end());
+        BOOST_CHECK(engine_bulk == engine_seq);
+        BOOST_CHECK_EQUAL(engine_bulk.getcounter()[1], 1);
+    }
+}
+
+
+
 
 BOOST_AUTO_TEST_CASE_TEMPLATE( engine_discard, T, threefry_types )
 {
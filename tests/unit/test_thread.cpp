@@ -35,6 +35,7 @@
 #include <stdexcept>
 #include <functional>
 #include <future>
+#include <atomic>
 
 #include <boost/test/unit_test.hpp>
 
@@ -127,6 +128,53 @@ BOOST_AUTO_TEST_CASE( executor_pool_thread_test)
 }
 
 
+BOOST_AUTO_TEST_CASE( executor_pool_work_stealing_test)
+{
+    hadoken::thread_pool_executor exec_thread(4, hadoken::thread_pool_scheduler::work_stealing);
+
+    BOOST_CHECK(exec_thread.scheduler() == hadoken::thread_pool_scheduler::work_stealing);
+
+    const int n_tasks = 64, n_subtasks = 32;
+    std::atomic<int> counter(0);
+    std::vector<std::future<int> > res;
+
+    // recursive submissions from inside the pool go to the local deque
+    for(int i =0; i < n_tasks; ++i){
+        res.emplace_back(exec_thread.twoway_execute([&exec_thread, &counter, i]{
+            std::vector<std::future<int> > sub_res;
+            for(int j =0; j < n_subtasks; ++j){
+                sub_res.emplace_back(exec_thread.twoway_execute([&counter, i, j]{
+                    counter += 1;
+                    return i + j;
+                }));
+            }
+
+            int sum = 0;
+            for(auto & f : sub_res){
+                sum += f.get();
+            }
+            return sum;
+        }));
+    }
+
+    int total = 0, expected = 0;
+    for(int i =0; i < n_tasks; ++i){
+        total += res[i].get();
+        expected += i * n_subtasks + (n_subtasks * (n_subtasks -1)) / 2;
+    }
+
+    BOOST_CHECK_EQUAL(total, expected);
+    BOOST_CHECK_EQUAL(counter.load(), n_tasks * n_subtasks);
+
+    auto f_error = exec_thread.twoway_execute([]() -> int{
+        throw std::runtime_error("task error");
+    });
+
+    BOOST_CHECK_THROW(f_error.get(), std::runtime_error);
+
+}
+
+
 BOOST_AUTO_TEST_CASE( latch_test)
 {
     {